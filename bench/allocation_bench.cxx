@@ -0,0 +1,268 @@
+// Allocation budget check: heap allocations per file in scan, plan and
+// operation materialization, against what owning each path costs at minimum.
+// Exits non-zero when a stage goes over budget, so a path copy creeping back
+// in between phases shows up as a failure. Allocations are read from the
+// instrumentation counters, so it needs FILEJANITOR_ENABLE_INSTRUMENTATION and
+// otherwise exits with skipped_exit_code.
+// Standard headers BEFORE fmt (fmt includes std headers internally)
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+import filejanitor;
+
+using namespace std::string_view_literals;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+  // CTest's SKIP_RETURN_CODE for builds without instrumentation
+  constexpr int skipped_exit_code{77};
+
+  // Per-run work (tables, reserve calls, the listing buffer) spread over the
+  // files; anything per file is at least 1
+  constexpr double slack_per_file{0.1};
+
+  struct guard_options
+  {
+    std::size_t files{20'000};
+    fs::path    base{fs::temp_directory_path()};
+  };
+
+  auto usage() -> std::string_view
+  {
+    return "Usage: allocation_bench [options]\n"
+           "      --files N          files in the generated directory\n"
+           "      --dir D            where the directory is generated\n"sv;
+  }
+
+  auto parse_options(const std::span<char* const> args)
+              -> std::optional<guard_options>
+  {
+    auto opts{guard_options{}};
+
+    for ( auto it{args.begin()}; it != args.end(); ++it )
+    {
+      const auto arg{std::string_view{*it}};
+      if ( std::next(it) == args.end() )
+        return std::nullopt;
+
+      const auto value{std::string_view{*++it}};
+      auto       number{std::size_t{0}};
+      const auto last{value.data() + value.size()};
+      const auto [end, ec]{std::from_chars(value.data(), last, number)};
+      const auto ok{ec == std::errc{} and end == last};
+
+      if ( arg == "--files"sv and ok )
+        opts.files = number;
+      else if ( arg == "--dir"sv )
+        opts.base = value;
+      else
+        return std::nullopt;
+    }
+
+    return opts;
+  }
+
+  // Longer than any small-string buffer, so no copy hides in one
+  auto file_name(const std::size_t idx) -> std::string
+  {
+    constexpr std::string_view extensions[]{"jpg", "pdf", "txt", "cxx"};
+    return fmt::format(
+                "allocation_guard_file_{:06}.{}",
+                idx,
+                extensions[idx % std::size(extensions)]
+    );
+  }
+
+  auto generate_directory(const fs::path& root, const std::size_t files) -> void
+  {
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    for ( auto idx{std::size_t{0}}; idx < files; ++idx )
+    {
+      [[maybe_unused]] const auto created{
+           std::ofstream{root / file_name(idx)}.good()
+      };
+    }
+  }
+
+  // Every allocation in the process is counted, so a stage that allocates
+  // shows up
+  template <typename Stage>
+  auto count_allocations(Stage&& stage) -> std::uint64_t
+  {
+    const auto before{instrumentation::allocations()};
+    std::forward<Stage>(stage)();
+    return instrumentation::allocations() - before;
+  }
+
+  // Building one owned path from scratch: its string plus whatever the path
+  // keeps beside it. No stage can hand out a path for less.
+  auto owned_path_cost(const fs::path& root) -> double
+  {
+    constexpr std::size_t samples{1'000};
+
+    auto kept{std::vector<fs::path>{}};
+    kept.reserve(samples);
+
+    const auto& dir{root.native()};
+    const auto  name{file_name(0)};
+    const auto  total{count_allocations([&] {
+      for ( auto idx{std::size_t{0}}; idx < samples; ++idx )
+      {
+        auto text{std::string{}};
+        text.reserve(dir.size() + 1 + name.size());
+        text.append(dir).append(1, '/').append(name);
+        kept.emplace_back(std::move(text));
+      }
+    })};
+
+    return static_cast<double>(total) / static_cast<double>(samples);
+  }
+
+  // What directory_iterator itself costs per entry, before anything is kept
+  auto listing_cost(const fs::path& root, const std::size_t files) -> double
+  {
+    const auto total{count_allocations([&] {
+      auto ec{std::error_code{}};
+      for ( auto it{fs::directory_iterator{root, ec}};
+            not ec and it != fs::directory_iterator{};
+            it.increment(ec) )
+      {}
+    })};
+
+    return static_cast<double>(total) / static_cast<double>(files);
+  }
+
+  struct stage_check
+  {
+    std::string_view label;
+    double           per_file{0};
+    double           budget{0};
+  };
+
+  auto report(const stage_check& check) -> bool
+  {
+    const auto within{check.per_file <= check.budget};
+    fmt::println(
+                "{:<16} {:>7.2f} allocations/file  budget {:>7.2f}  {}",
+                check.label,
+                check.per_file,
+                check.budget,
+                within ? "ok" : "OVER BUDGET"
+    );
+    return within;
+  }
+} // namespace
+
+auto main(const int argc, char* argv[]) -> int
+{
+  const auto parsed{
+       parse_options(std::span{argv, static_cast<std::size_t>(argc)}.subspan(1))
+  };
+
+  if ( not parsed or parsed->files == 0 )
+  {
+    fmt::print(stderr, "{}", usage());
+    return 1;
+  }
+
+  if constexpr ( not instrumentation::enabled )
+  {
+    fmt::println("allocation_bench needs FILEJANITOR_ENABLE_INSTRUMENTATION=ON");
+    return skipped_exit_code;
+  }
+
+  const auto& opts{*parsed};
+  const auto  root{opts.base / "filejanitor_allocation_guard"};
+  const auto  count{static_cast<double>(opts.files)};
+
+  generate_directory(root, opts.files);
+
+  const auto owned{owned_path_cost(root)};
+  const auto listing{listing_cost(root, opts.files)};
+  auto       checks{std::vector<stage_check>{}};
+
+  // Scan: the listing, plus the one path each file keeps
+  auto files{std::vector<fs::path>{}};
+  const auto standard_scan{count_allocations([&] {
+    files = fs_ops::scanner::collect_files(root, {}).file_bin;
+  })};
+  checks.push_back({
+       .label{"scan (standard)"},
+       .per_file{static_cast<double>(standard_scan) / count},
+       .budget{listing + owned + slack_per_file},
+  });
+
+#if defined(__linux__)
+  const auto native_scan{count_allocations([&] {
+    const auto options{fs_ops::scanner::scan_options{
+         .backend = fs_ops::scanner::scan_backend::native,
+    }};
+    files = fs_ops::scanner::collect_files(root, options).file_bin;
+  })};
+  checks.push_back({
+       .label{"scan (native)"},
+       .per_file{static_cast<double>(native_scan) / count},
+       .budget{owned + slack_per_file},
+  });
+#endif
+
+  // Plan: paths are moved in and read in place, names land in the plan's arena
+  auto plan{fs_ops::compact_plan{root}};
+  const auto planning{count_allocations([&] {
+    plan = fs_ops::planner::generate_compact_plan(
+                std::move(files),
+                root,
+                {.worker_count = 1}
+    );
+  })};
+  checks.push_back({
+       .label{"plan"},
+       .per_file{static_cast<double>(planning) / count},
+       .budget{slack_per_file},
+  });
+
+  // What the executor builds per operation: a source and a destination path
+  const auto materializing{count_allocations([&] {
+    for ( auto idx{std::size_t{0}}; idx < plan.size(); ++idx )
+    {
+      [[maybe_unused]] const auto op{plan.operation(idx)};
+    }
+  })};
+  checks.push_back({
+       .label{"materialize"},
+       .per_file{static_cast<double>(materializing) / count},
+       .budget{2 * owned + slack_per_file},
+  });
+
+  fs::remove_all(root);
+
+  fmt::println(
+              "{} files; one owned path costs {:.2f}, a listed entry {:.2f}",
+              opts.files,
+              owned,
+              listing
+  );
+
+  auto within{true};
+  for ( const auto& check : checks )
+    within = report(check) and within;
+
+  return within ? 0 : 1;
+}
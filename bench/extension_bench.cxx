@@ -0,0 +1,145 @@
+// Microbenchmark: extension normalization, legacy path-based vs. SWAR.
+// Allocations are read from the instrumentation counters, so they are only
+// reported with FILEJANITOR_ENABLE_INSTRUMENTATION.
+// Standard headers BEFORE fmt (fmt includes std headers internally)
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+import filejanitor;
+
+namespace fs  = std::filesystem;
+namespace rng = std::ranges;
+namespace vws = std::views;
+
+namespace
+{
+  constexpr std::size_t corpus_size{1'000'000};
+  constexpr int         rounds{5};
+
+  // What the planner did before: two path/string copies plus a transformed one
+  auto legacy_normalize(const fs::path& path) -> std::string
+  {
+    return not path.has_extension()
+                       ? std::string{}
+                       : path.extension().string()
+                                     | vws::transform([](const unsigned char c) {
+                                         return std::tolower(c);
+                                       })
+                                     | rng::to<std::string>();
+  }
+
+  auto make_corpus() -> std::vector<fs::path>
+  {
+    constexpr const char* names[]{
+         "IMG_2041.JPG",     "report.final.PDF", "notes.txt",   ".bashrc",
+         "archive.tar.GZ",   "Makefile",         "clip.MoV",    "données.CSV",
+         "build.log",        "photo.jpeg",       "main.CXX",    "README",
+         "slides.pptx",      "track01.FLAC",     "data.parquet", "font.WOFF2",
+    };
+
+    return vws::iota(std::size_t{0}, corpus_size)
+           | vws::transform([&names](const std::size_t idx) {
+               return fs::path{"/srv/inbox"} / names[idx % std::size(names)];
+             })
+           | rng::to<std::vector>();
+  }
+
+  struct measurement
+  {
+    double        ns_per_file{0};
+    std::uint64_t allocations_per_round{0};
+    std::size_t   checksum{0};
+  };
+
+  template <typename Normalize>
+  auto measure(const std::vector<fs::path>& corpus, Normalize&& normalize)
+              -> measurement
+  {
+    auto best{std::chrono::nanoseconds::max()};
+    auto result{measurement{}};
+
+    for ( auto round{0}; round < rounds; ++round )
+    {
+      // Every allocation in the process is counted, so a pass that
+      // allocates shows up
+      const auto before{instrumentation::allocations()};
+      const auto start{std::chrono::steady_clock::now()};
+
+      auto checksum{std::size_t{0}};
+      for ( const auto& path : corpus )
+        checksum += normalize(path).size();
+
+      const auto elapsed{std::chrono::steady_clock::now() - start};
+
+      const auto after{instrumentation::allocations()};
+
+      result.allocations_per_round = after - before;
+      result.checksum              = checksum;
+      best                         = std::min(best, elapsed);
+    }
+
+    result.ns_per_file = static_cast<double>(best.count())
+                         / static_cast<double>(corpus.size());
+    return result;
+  }
+
+  auto report(const char* label, const measurement& m, const std::size_t files)
+              -> void
+  {
+    if constexpr ( not instrumentation::enabled )
+    {
+      fmt::println("{:<8} {:>8.2f} ns/file", label, m.ns_per_file);
+      return;
+    }
+
+    const auto per_file{static_cast<double>(m.allocations_per_round)
+                        / static_cast<double>(files)};
+
+    fmt::println(
+                "{:<8} {:>8.2f} ns/file  {:>10} allocations ({:.2f}/file)",
+                label,
+                m.ns_per_file,
+                m.allocations_per_round,
+                per_file
+    );
+  }
+} // namespace
+
+auto main() -> int
+{
+  const auto corpus{make_corpus()};
+
+  // Both implementations must agree before their timings mean anything
+  for ( const auto& path : corpus | vws::take(64) )
+  {
+    if ( legacy_normalize(path) != fs_ops::planner::normalize_extension(path) )
+    {
+      fmt::println(stderr, "mismatch on '{}'", path.string());
+      return 1;
+    }
+  }
+
+  const auto legacy{measure(corpus, legacy_normalize)};
+  const auto swar{measure(corpus, fs_ops::planner::normalize_extension)};
+
+  fmt::println(
+              "normalize_extension over {} paths, best of {} rounds",
+              corpus.size(),
+              rounds
+  );
+  report("legacy", legacy, corpus.size());
+  report("swar", swar, corpus.size());
+  fmt::println("speedup  {:.2f}x", legacy.ns_per_file / swar.ns_per_file);
+
+  return legacy.checksum == swar.checksum ? 0 : 1;
+}
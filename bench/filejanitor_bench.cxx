@@ -0,0 +1,377 @@
+// Benchmark suite: scan, plan and execute over synthetic trees, per stage and
+// end to end, reporting files/sec per stage and the run's peak RSS
+// Standard headers BEFORE fmt (fmt includes std headers internally)
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/resource.h>
+#endif
+
+#if defined(__linux__)
+#  include <linux/magic.h>
+#  include <sys/vfs.h>
+#endif
+
+#include <fmt/format.h>
+
+import filejanitor;
+
+using namespace std::string_view_literals;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+  using bench_clock = std::chrono::steady_clock;
+
+  struct extension_share
+  {
+    std::string extension;   // without the dot, empty = no extension
+    std::size_t weight{1};
+  };
+
+  // What a generated tree looks like. Files are spread round-robin over a tree
+  // of `depth` levels with `fanout` subdirectories each; collision_percent of
+  // them already have a same-named file waiting in their bucket.
+  struct tree_spec
+  {
+    std::size_t                  files{100'000};
+    std::size_t                  depth{0};
+    std::size_t                  fanout{8};
+    std::size_t                  collision_percent{0};
+    std::vector<extension_share> extensions{
+         {"jpg", 30}, {"pdf", 20}, {"txt", 20}, {"mp4", 10},
+         {"tar.gz", 5}, {"cxx", 10}, {"", 5},
+    };
+  };
+
+  struct bench_options
+  {
+    tree_spec   tree{};
+    fs::path    base{fs::temp_directory_path()};
+    std::size_t rounds{3};
+    std::size_t workers{1};   // planner and executor threads
+  };
+
+  auto usage() -> std::string_view
+  {
+    return "Usage: filejanitor_bench [options]\n"
+           "      --files N          files per generated tree\n"
+           "      --depth N          directory levels below the root\n"
+           "      --fanout N         subdirectories per level\n"
+           "      --collisions P     percent of files whose target already exists\n"
+           "      --extensions L     weighted list, e.g. jpg:30,pdf:20,none:5\n"
+           "      --dir D            where trees are generated (tmpfs or disk)\n"
+           "      --rounds N         repetitions; the best time is reported\n"
+           "      --threads N        planner and executor workers\n"sv;
+  }
+
+  template <typename T>
+  auto parse_number(const std::string_view text) -> std::optional<T>
+  {
+    auto       value{T{}};
+    const auto last{text.data() + text.size()};
+    const auto [end, ec]{std::from_chars(text.data(), last, value)};
+
+    return ec == std::errc{} and end == last ? std::optional<T>{value}
+                                             : std::nullopt;
+  }
+
+  auto parse_extensions(std::string_view list)
+              -> std::optional<std::vector<extension_share>>
+  {
+    auto shares{std::vector<extension_share>{}};
+
+    while ( not list.empty() )
+    {
+      const auto comma{std::min(list.find(','), list.size())};
+      const auto item{list.substr(0, comma)};
+      list.remove_prefix(std::min(comma + 1, list.size()));
+
+      const auto colon{item.find(':')};
+      if ( colon == std::string_view::npos )
+        return std::nullopt;
+
+      const auto weight{parse_number<std::size_t>(item.substr(colon + 1))};
+      if ( not weight )
+        return std::nullopt;
+
+      const auto name{item.substr(0, colon)};
+      shares.push_back({
+           .extension{name == "none"sv ? std::string{} : std::string{name}},
+           .weight{*weight},
+      });
+    }
+
+    return shares.empty() ? std::nullopt : std::optional{std::move(shares)};
+  }
+
+  auto parse_options(const std::span<char* const> args)
+              -> std::optional<bench_options>
+  {
+    auto opts{bench_options{}};
+
+    for ( auto it{args.begin()}; it != args.end(); ++it )
+    {
+      const auto arg{std::string_view{*it}};
+      if ( std::next(it) == args.end() )
+        return std::nullopt;
+
+      const auto value{std::string_view{*++it}};
+      const auto number{parse_number<std::size_t>(value)};
+      const auto ok{number.has_value()};
+
+      if ( arg == "--files"sv and ok )
+        opts.tree.files = *number;
+      else if ( arg == "--depth"sv and ok )
+        opts.tree.depth = *number;
+      else if ( arg == "--fanout"sv and ok )
+        opts.tree.fanout = std::max<std::size_t>(1, *number);
+      else if ( arg == "--collisions"sv and ok )
+        opts.tree.collision_percent = std::min<std::size_t>(100, *number);
+      else if ( arg == "--rounds"sv and ok )
+        opts.rounds = std::max<std::size_t>(1, *number);
+      else if ( arg == "--threads"sv and ok )
+        opts.workers = *number;
+      else if ( arg == "--dir"sv )
+        opts.base = value;
+      else if ( arg == "--extensions"sv )
+      {
+        auto shares{parse_extensions(value)};
+        if ( not shares )
+          return std::nullopt;
+        opts.tree.extensions = std::move(*shares);
+      }
+      else
+        return std::nullopt;
+    }
+
+    return opts;
+  }
+
+  auto filesystem_kind(const fs::path& path) -> std::string_view
+  {
+#if defined(__linux__)
+    struct statfs info{};
+    if ( ::statfs(path.c_str(), &info) == 0 and info.f_type == TMPFS_MAGIC )
+      return "tmpfs";
+    return "disk";
+#else
+    static_cast<void>(path);
+    return "unknown";
+#endif
+  }
+
+  // Peak resident set size of the whole process so far, in MiB. Never falls
+  // back, so it cannot be told apart per stage within one process.
+  auto peak_rss_mib() -> double
+  {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+#  if defined(__APPLE__)
+    return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);   // bytes
+#  else
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;   // KiB
+#  endif
+#else
+    return 0.0;
+#endif
+  }
+
+  auto touch(const fs::path& file) -> void
+  {
+    [[maybe_unused]] const auto created{std::ofstream{file}.good()};
+  }
+
+  // The extension for file idx, following the weights deterministically
+  auto pick_extension(const tree_spec& spec, const std::size_t idx)
+              -> const std::string&
+  {
+    auto total{std::size_t{0}};
+    for ( const auto& share : spec.extensions )
+      total += share.weight;
+
+    auto slot{total == 0 ? 0 : (idx * 7919) % total};
+    for ( const auto& share : spec.extensions )
+    {
+      if ( slot < share.weight )
+        return share.extension;
+      slot -= share.weight;
+    }
+
+    return spec.extensions.back().extension;
+  }
+
+  auto generate_tree(const tree_spec& spec, const fs::path& root) -> void
+  {
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    // Leaf directories of the nested layout, files are dealt out over them
+    auto leaves{std::vector<fs::path>{root}};
+    for ( auto level{std::size_t{0}}; level < spec.depth; ++level )
+    {
+      auto next{std::vector<fs::path>{}};
+      for ( const auto& dir : leaves )
+      {
+        for ( auto sub{std::size_t{0}}; sub < spec.fanout; ++sub )
+        {
+          next.push_back(dir / fmt::format("d{}", sub));
+          fs::create_directories(next.back());
+        }
+      }
+      leaves = std::move(next);
+    }
+
+    for ( auto idx{std::size_t{0}}; idx < spec.files; ++idx )
+    {
+      const auto& extension{pick_extension(spec, idx)};
+      const auto  name{extension.empty() ? fmt::format("f{}", idx)
+                                         : fmt::format("f{}.{}", idx, extension)};
+
+      touch(leaves[idx % leaves.size()] / name);
+
+      if ( (idx * 37) % 100 < spec.collision_percent )
+      {
+        // The planner's bucket for this file, from its last extension only
+        const auto bucket_name{fs::path{name}.extension().string()};
+        const auto bucket{root / (bucket_name.empty() ? "no_extension"
+                                                      : bucket_name.substr(1))};
+        fs::create_directories(bucket);
+        touch(bucket / name);
+      }
+    }
+  }
+
+  struct stage_result
+  {
+    std::chrono::nanoseconds best{std::chrono::nanoseconds::max()};
+    std::size_t              files{0};
+  };
+
+  template <typename Stage>
+  auto time_stage(stage_result& result, Stage&& stage)
+  {
+    const auto start{bench_clock::now()};
+    auto       value{std::forward<Stage>(stage)()};
+    result.best = std::min(result.best, bench_clock::now() - start);
+    return value;
+  }
+
+  auto print_stage(const std::string_view label, const stage_result& result) -> void
+  {
+    const auto seconds{std::chrono::duration<double>(result.best).count()};
+    const auto rate{seconds > 0 ? static_cast<double>(result.files) / seconds : 0.0};
+
+    fmt::println(
+                "{:<10} {:>10} files  {:>9.4f} s  {:>12.0f} files/s",
+                label,
+                result.files,
+                seconds,
+                rate
+    );
+  }
+} // namespace
+
+auto main(const int argc, char* argv[]) -> int
+{
+  const auto parsed{
+       parse_options(std::span{argv, static_cast<std::size_t>(argc)}.subspan(1))
+  };
+
+  if ( not parsed )
+  {
+    fmt::print(stderr, "{}", usage());
+    return 1;
+  }
+
+  const auto& opts{*parsed};
+  const auto  root{opts.base / "filejanitor_bench_tree"};
+  const auto  planning{
+       fs_ops::planner::planning_options{.worker_count = opts.workers}
+  };
+  const auto  execution{
+       fs_ops::executor::execution_options{.worker_count = opts.workers}
+  };
+  const auto  scanning{fs_ops::scanner::scan_options{.recursive = true}};
+
+  fmt::println(
+              "{} files, depth {} x{}, {}% collisions, {} ({}), best of {} rounds",
+              opts.tree.files,
+              opts.tree.depth,
+              opts.tree.fanout,
+              opts.tree.collision_percent,
+              opts.base.string(),
+              filesystem_kind(opts.base),
+              opts.rounds
+  );
+
+  auto scan{stage_result{}};
+  auto plan{stage_result{}};
+  auto execute{stage_result{}};
+  auto end_to_end{stage_result{}};
+  auto failures{std::int64_t{0}};
+
+  for ( auto round{std::size_t{0}}; round < opts.rounds; ++round )
+  {
+    // Each stage on its own; executing consumes the tree, so it is rebuilt
+    generate_tree(opts.tree, root);
+
+    auto collected{time_stage(scan, [&] {
+      return fs_ops::scanner::collect_files(root, scanning);
+    })};
+    scan.files = collected.file_bin.size();
+
+    const auto movement{time_stage(plan, [&] {
+      auto files{std::move(collected.file_bin)};
+      return fs_ops::planner::generate_plan(std::move(files), root, planning);
+    })};
+    plan.files = movement.operations.size();
+
+    const auto report{time_stage(execute, [&] {
+      return fs_ops::executor::execute_plan(movement, execution);
+    })};
+    execute.files = static_cast<std::size_t>(report.processed_count());
+    failures      = std::max(failures, report.failure_count());
+
+    // All three back to back, the way Main runs them
+    generate_tree(opts.tree, root);
+
+    const auto full{time_stage(end_to_end, [&] {
+      auto files{fs_ops::scanner::collect_files(root, scanning).file_bin};
+      const auto compact{
+           fs_ops::planner::generate_compact_plan(std::move(files), root, planning)
+      };
+      return fs_ops::executor::execute_plan(compact, execution);
+    })};
+    end_to_end.files = static_cast<std::size_t>(full.processed_count());
+  }
+
+  fs::remove_all(root);
+
+  print_stage("scan", scan);
+  print_stage("plan", plan);
+  print_stage("execute", execute);
+  print_stage("end-to-end", end_to_end);
+  fmt::println("peak RSS {:.1f} MiB over the whole run", peak_rss_mib());
+
+  if ( failures > 0 )
+    fmt::println(stderr, "up to {} operations failed per round", failures);
+
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+// Module partition: arena
+// Exports: run_arena class, resource_or_heap(), string_hash, string_equal,
+//          string_set, string_map
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+export module filejanitor:arena;
+
+// Define and export the per-run memory arena
+export namespace fs_ops::arena {
+    // A monotonic arena for one run: small tables come out of a few large
+    // blocks, deallocation is a no-op, and every block is released at once when
+    // the arena goes away. Safe to share between threads, so the parallel
+    // scanner, planner and executor can all use it: every thread bump-allocates
+    // from a thread_chunk_size chunk of its own without locking, and only takes
+    // the lock to carve out its next chunk (or an allocation too big for one).
+    // Memory is only reclaimed at the end, so nothing long-lived (a watch) should
+    // allocate from it.
+    class run_arena final : public std::pmr::memory_resource {
+    public:
+        static constexpr std::size_t default_block_size{1024UZ * 1024UZ};
+        static constexpr std::size_t thread_chunk_size{64UZ * 1024UZ};
+
+        explicit run_arena(std::size_t initial_block_size = default_block_size);
+
+        run_arena(const run_arena&)                    = delete;
+        auto operator=(const run_arena&) -> run_arena& = delete;
+
+        ~run_arena() override = default;
+
+        // Bytes taken out of the blocks so far, not counting block slack. Chunks
+        // count whole, so this runs up to a chunk per thread ahead of what was
+        // handed out.
+        [[nodiscard]] auto bytes_allocated() const -> std::size_t;
+
+    private:
+        auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override;
+        auto do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+            -> void override;
+        [[nodiscard]] auto do_is_equal(const std::pmr::memory_resource& other) const noexcept
+            -> bool override;
+
+        // Under mutex_
+        auto take(std::size_t bytes, std::size_t alignment) -> void*;
+
+        // Tells this arena's chunks apart from those of one that lived at the
+        // same address before
+        std::uint64_t                       id_;
+        mutable std::mutex                  mutex_{};
+        std::pmr::monotonic_buffer_resource blocks_;
+        std::size_t                         allocated_{0};
+    };
+
+    // Options leave their memory resource null to mean the global heap
+    [[nodiscard]] inline auto resource_or_heap(std::pmr::memory_resource* const memory) noexcept
+        -> std::pmr::memory_resource* {
+        return memory != nullptr ? memory : std::pmr::new_delete_resource();
+    }
+
+    // Let std::string and string_view look up pmr::string keys without first
+    // building a key in the arena (the two string types do not compare directly)
+    struct string_hash {
+        using is_transparent = void;
+
+        auto operator()(const std::string_view text) const noexcept -> std::size_t {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+    struct string_equal {
+        using is_transparent = void;
+
+        auto operator()(const std::string_view a, const std::string_view b) const noexcept
+            -> bool {
+            return a == b;
+        }
+    };
+
+    using string_set = std::pmr::unordered_set<std::pmr::string, string_hash, string_equal>;
+
+    template <typename T>
+    using string_map = std::pmr::unordered_map<std::pmr::string, T, string_hash, string_equal>;
+}
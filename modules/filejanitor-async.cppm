@@ -0,0 +1,347 @@
+// Module partition: async
+// Exports: task, io_backend, loop_options, io_loop class, task_group class
+// Depends on: concurrency, result_types, safe_fs
+module;
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+export module filejanitor:async;
+
+// Re-export dependency partitions
+export import :result_types;
+export import :safe_fs;
+
+import :concurrency;
+
+// Define and export the coroutine runtime the async executor runs on
+export namespace fs_ops::async {
+    template <typename T>
+    class task;
+
+    namespace detail {
+        // What a finished task hands its awaiter: a value, or nothing for task<void>
+        template <typename T>
+        class task_result {
+        public:
+            auto return_value(T value) -> void { value_.emplace(std::move(value)); }
+            auto take() -> T { return std::move(*value_); }
+
+        private:
+            std::optional<T> value_{};
+        };
+
+        template <>
+        class task_result<void> {
+        public:
+            auto return_void() noexcept -> void {}
+            auto take() noexcept -> void {}
+        };
+    }
+
+    // Lazy coroutine: nothing runs until it is awaited (or handed to
+    // io_loop::run), and it resumes its awaiter by symmetric transfer when it
+    // finishes, so chains of awaits never grow the stack. Errors travel as
+    // Result values; an escaping exception terminates. Move-only.
+    template <typename T>
+    class [[nodiscard]] task {
+    public:
+        struct promise_type : detail::task_result<T> {
+            auto get_return_object() -> task {
+                return task{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+
+            auto final_suspend() noexcept {
+                struct resume_awaiter {
+                    auto await_ready() noexcept -> bool { return false; }
+                    auto await_suspend(std::coroutine_handle<promise_type> done) noexcept
+                        -> std::coroutine_handle<> {
+                        const auto next{done.promise().continuation};
+                        return next ? next : std::noop_coroutine();
+                    }
+                    auto await_resume() noexcept -> void {}
+                };
+                return resume_awaiter{};
+            }
+
+            auto unhandled_exception() noexcept -> void { std::terminate(); }
+
+            std::coroutine_handle<> continuation{};
+        };
+
+        task(const task&)                    = delete;
+        auto operator=(const task&) -> task& = delete;
+
+        task(task&& other) noexcept
+            : handle_{std::exchange(other.handle_, {})}
+        {}
+
+        auto operator=(task&& other) noexcept -> task& {
+            if ( this != &other ) {
+                if ( handle_ )
+                    handle_.destroy();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+
+        ~task() {
+            if ( handle_ )
+                handle_.destroy();
+        }
+
+        auto operator co_await() && noexcept {
+            struct awaiter {
+                std::coroutine_handle<promise_type> handle;
+
+                auto await_ready() noexcept -> bool { return false; }
+                auto await_suspend(const std::coroutine_handle<> waiting) noexcept
+                    -> std::coroutine_handle<> {
+                    handle.promise().continuation = waiting;
+                    return handle;
+                }
+                auto await_resume() -> T { return handle.promise().take(); }
+            };
+            return awaiter{handle_};
+        }
+
+    private:
+        friend class io_loop;
+        friend class task_group;
+
+        explicit task(const std::coroutine_handle<promise_type> handle) noexcept
+            : handle_{handle}
+        {}
+
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    // thread_pool: each rename is a blocking syscall on one of io_threads
+    //              threads, so up to that many run at once
+    // io_uring:    renames are RENAME_NOREPLACE SQEs submitted from the loop's
+    //              own thread, thousands at a time (builds with
+    //              FILEJANITOR_ENABLE_IO_URING, else thread_pool)
+    // Either way, offloaded work (copies, path fallbacks) takes the I/O threads.
+    enum class io_backend : std::int8_t {
+        thread_pool,
+        io_uring,
+    };
+
+    struct loop_options {
+        io_backend  backend{io_backend::thread_pool};
+        std::size_t io_threads{4};
+        std::size_t max_in_flight{1024};   // operations a task_group keeps running
+    };
+
+    // Runs coroutines on the calling thread of run(), resuming each one there
+    // as the I/O it awaits completes. I/O threads never run coroutine code, so
+    // state shared by the coroutines of one loop needs no locking.
+    class io_loop {
+    public:
+        explicit io_loop(const loop_options& options);
+
+        io_loop(const io_loop&)                    = delete;
+        auto operator=(const io_loop&) -> io_loop& = delete;
+        ~io_loop();
+
+        // thread_pool when io_uring was asked for but could not be set up
+        [[nodiscard]] auto backend() const noexcept -> io_backend;
+        [[nodiscard]] auto max_in_flight() const noexcept -> std::size_t;
+
+        // Drives root, and everything it spawns, to completion
+        template <typename T>
+        auto run(task<T> root) -> T {
+            root.handle_.resume();
+            while ( not root.handle_.done() )
+                wait_and_resume();
+
+            return root.handle_.promise().take();
+        }
+
+        class rename_awaitable {
+        public:
+            auto await_ready() const noexcept -> bool { return false; }
+            auto await_suspend(std::coroutine_handle<> waiting) -> void;
+            auto await_resume() noexcept -> VoidResult { return result_; }
+
+        private:
+            friend class io_loop;
+
+            rename_awaitable(
+                io_loop&                         loop,
+                const safe_fs::directory_handle& from_dir,
+                const std::filesystem::path&     from_name,
+                const safe_fs::directory_handle& to_dir,
+                const std::filesystem::path&     to_name
+            ) noexcept
+                : loop_{loop}, from_dir_{from_dir}, from_name_{from_name},
+                  to_dir_{to_dir}, to_name_{to_name}
+            {}
+
+            io_loop&                         loop_;
+            const safe_fs::directory_handle& from_dir_;
+            const std::filesystem::path&     from_name_;
+            const safe_fs::directory_handle& to_dir_;
+            const std::filesystem::path&     to_name_;
+            VoidResult                       result_{};
+            std::coroutine_handle<>          waiting_{};
+        };
+
+        // safe_fs::rename_at, awaited. Everything passed must outlive the await.
+        [[nodiscard]] auto rename_at(
+            const safe_fs::directory_handle& from_dir,
+            const std::filesystem::path&     from_name,
+            const safe_fs::directory_handle& to_dir,
+            const std::filesystem::path&     to_name
+        ) noexcept -> rename_awaitable {
+            return {*this, from_dir, from_name, to_dir, to_name};
+        }
+
+        template <typename Work>
+        class offload_awaitable {
+        public:
+            using result_type = std::invoke_result_t<Work&>;
+
+            auto await_ready() const noexcept -> bool { return false; }
+            auto await_suspend(const std::coroutine_handle<> waiting) -> void {
+                loop_.submit([this, waiting] {
+                    result_.emplace(work_());
+                    loop_.post(waiting);
+                });
+            }
+            auto await_resume() -> result_type { return std::move(*result_); }
+
+        private:
+            friend class io_loop;
+
+            offload_awaitable(io_loop& loop, Work&& work)
+                : loop_{loop}, work_{std::move(work)}
+            {}
+
+            io_loop&                   loop_;
+            Work                       work_;
+            std::optional<result_type> result_{};
+        };
+
+        // Runs work on an I/O thread and resumes with its result. work must not
+        // touch anything the loop's coroutines share.
+        template <typename Work>
+        [[nodiscard]] auto offload(Work work) -> offload_awaitable<Work> {
+            return {*this, std::move(work)};
+        }
+
+        // Resumes waiting on the loop thread; callable from any thread
+        auto post(std::coroutine_handle<> waiting) -> void;
+
+    private:
+        struct ring;
+        using job = std::move_only_function<void()>;
+
+        auto submit(job work) -> void;
+        auto submit_rename(rename_awaitable& rename) -> void;
+        auto rename_on_thread(rename_awaitable& rename) -> void;
+
+        // A ring the kernel stopped taking submissions from, with nothing left
+        // in flight, is closed; what it still held runs on the I/O threads and
+        // so does every later rename
+        auto abandon_ring() -> void;
+
+        // One round: resumes whatever was posted, reaps the ring, and blocks
+        // only when neither had anything
+        auto wait_and_resume() -> void;
+        auto take_posted(bool block) -> void;
+        auto reap_ring(bool block) -> void;
+
+        std::size_t                          max_in_flight_;
+        std::unique_ptr<ring>                ring_;
+        std::mutex                           mutex_{};
+        std::condition_variable              posted_{};
+        std::vector<std::coroutine_handle<>> ready_{};
+        std::vector<std::coroutine_handle<>> resuming_{};
+        std::atomic<std::size_t>             offloaded_{0};   // jobs not yet done
+        concurrency::bounded_queue<job>      jobs_;
+        std::vector<std::jthread>            threads_{};
+    };
+
+    // At most `limit` spawned tasks running at once on one loop. Meant for the
+    // single coroutine that spawns them (it is the only one ever waiting), and
+    // must outlive every task it started: join() before it goes away.
+    class task_group {
+    public:
+        task_group(io_loop& loop, std::size_t limit) noexcept;
+
+        task_group(const task_group&)                    = delete;
+        auto operator=(const task_group&) -> task_group& = delete;
+
+        // Suspends while the group is full, then starts work detached
+        [[nodiscard]] auto spawn(task<void> work) noexcept {
+            struct awaiter {
+                task_group& group;
+                task<void>  work;
+
+                auto await_ready() const noexcept -> bool {
+                    return group.running_ < group.limit_;
+                }
+                auto await_suspend(const std::coroutine_handle<> waiting) noexcept -> void {
+                    group.waiting_    = waiting;
+                    group.wake_below_ = group.limit_;
+                }
+                auto await_resume() -> void { group.start(std::move(work)); }
+            };
+            return awaiter{*this, std::move(work)};
+        }
+
+        // Suspends until every spawned task finished
+        [[nodiscard]] auto join() noexcept {
+            struct awaiter {
+                task_group& group;
+
+                auto await_ready() const noexcept -> bool { return group.running_ == 0; }
+                auto await_suspend(const std::coroutine_handle<> waiting) noexcept -> void {
+                    group.waiting_    = waiting;
+                    group.wake_below_ = 1;
+                }
+                auto await_resume() noexcept -> void {}
+            };
+            return awaiter{*this};
+        }
+
+    private:
+        // Owns a started task until it finishes, then frees itself
+        struct detached {
+            struct promise_type {
+                auto get_return_object() noexcept -> detached { return {}; }
+                auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+                auto final_suspend() noexcept -> std::suspend_never { return {}; }
+                auto return_void() noexcept -> void {}
+                auto unhandled_exception() noexcept -> void { std::terminate(); }
+            };
+        };
+
+        static auto run_detached(task<void> work, task_group& group) -> detached;
+
+        auto start(task<void> work) -> void;
+        auto finished() -> void;
+
+        io_loop&                loop_;
+        std::size_t             limit_;
+        std::size_t             running_{0};
+        std::size_t             wake_below_{0};
+        std::coroutine_handle<> waiting_{};
+    };
+}
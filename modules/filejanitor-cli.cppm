@@ -0,0 +1,61 @@
+// Module partition: cli
+// Exports: options, parse_arguments(), usage()
+// Depends on: result_types, scanner, planner, dedup, executor, pipeline, watcher, output
+module;
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+export module filejanitor:cli;
+
+// Re-export dependency partitions
+export import :result_types;
+export import :scanner;
+export import :planner;
+export import :dedup;
+export import :executor;
+export import :pipeline;
+export import :watcher;
+export import :output;
+
+// Define and export command-line types
+export namespace cli {
+    struct options {
+        std::filesystem::path               root{"."};
+        std::vector<std::filesystem::path>  roots{};          // set only when several are given
+        std::filesystem::path               manifest_file{};  // more roots, one per line
+        std::size_t                         root_workers{0};  // roots at once, 0 = hardware
+        fs_ops::scanner::scan_options       scan{};
+        fs_ops::planner::planning_options   planning{};
+        std::filesystem::path               rules_file{};     // bucket rules to plan with
+        bool                                deduplicating{false};
+        fs_ops::dedup::dedup_options        dedup{};
+        fs_ops::executor::execution_options execution{.worker_count = 1};
+        bool                                async_execution{false};  // coroutine executor
+        fs_ops::async::loop_options         loop{};
+        bool                                pipelined{false};
+        fs_ops::pipeline::pipeline_options  pipeline{};
+        bool                                watching{false};
+        fs_ops::watcher::watch_options      watch{};
+        std::filesystem::path               write_plan{};     // plan only, save here
+        std::filesystem::path               execute_plan{};   // skip scan/plan, run this file
+        std::filesystem::path               journal_file{};   // record completed moves
+        bool                                resuming{false};  // finish journal_file's plan
+        bool                                undoing{false};   // reverse journal_file's moves
+        bool                                dry_run{false};   // resolve names, move nothing
+        std::filesystem::path               index_file{};     // incremental rescans
+        std::filesystem::path               stats_file{};     // instrumentation JSON, "-" = stdout
+        output::output_mode                 output{output::output_mode::full};
+        std::filesystem::path               ndjson_file{};    // structured plan/report log
+        std::filesystem::path               report_file{};    // execution report, for merging
+        std::vector<std::filesystem::path>  merge_reports{};  // merge these, run nothing
+    };
+
+    // args excludes the program name (argv[0])
+    [[nodiscard]] auto parse_arguments(std::span<char* const> args) -> Result<options>;
+
+    [[nodiscard]] auto usage() noexcept -> std::string_view;
+}
@@ -0,0 +1,104 @@
+// Module partition: compact_plan
+// Exports: compact_operation, compact_plan class
+// Depends on: arena, movement_plan (transitively: fs_ops)
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+export module filejanitor:compact_plan;
+
+// Re-export dependency partition
+export import :arena;
+export import :movement_plan;
+
+// Define and export the compact plan representation
+export namespace fs_ops {
+    // One planned move, by reference into the plan's tables. The filename is a
+    // slice of the plan's name arena; both paths are rebuilt from it on demand.
+    struct compact_operation {
+        std::size_t   name_offset{0};
+        std::uint32_t name_length{0};
+        std::uint32_t source_dir{0};   // index into the source directory table
+        std::uint32_t bucket{0};       // index into the bucket name table
+    };
+
+    // Same operations as a movement_plan, without three owned strings per file:
+    // bucket names and source directories are interned once, filenames live in
+    // one contiguous arena, and destinations are always root / bucket / name.
+    class compact_plan {
+    public:
+        explicit compact_plan(std::filesystem::path root_path);
+
+        auto reserve(std::size_t operation_count) -> void;
+
+        // Returns the id of `name`, adding it to the table on first use
+        [[nodiscard]] auto intern_bucket(std::string_view name) -> std::uint32_t;
+
+        // Plans source -> root / bucket_name(bucket) / source.filename(). Reads
+        // source in place: nothing is allocated beyond the tables' own growth,
+        // and the metadata table only grows once some file brought metadata.
+        auto add(
+            const std::filesystem::path& source,
+            std::uint32_t                bucket,
+            const file_metadata&         metadata = {}
+        ) -> void;
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+        [[nodiscard]] auto empty() const noexcept -> bool;
+        [[nodiscard]] auto root() const noexcept -> const std::filesystem::path&;
+        [[nodiscard]] auto bucket_count() const noexcept -> std::size_t;
+        [[nodiscard]] auto bucket_name(std::uint32_t bucket) const -> const std::string&;
+
+        [[nodiscard]] auto source_dir_count() const noexcept -> std::size_t;
+        [[nodiscard]] auto source_dir(std::uint32_t dir) const -> const std::filesystem::path&;
+
+        // Raw tables, for serializers
+        [[nodiscard]] auto record(std::size_t index) const -> const compact_operation&;
+        [[nodiscard]] auto name_arena() const noexcept -> std::string_view;
+
+        [[nodiscard]] auto bucket_of(std::size_t index) const -> std::uint32_t;
+        // What the scan learned of the source; not known when it was not asked
+        [[nodiscard]] auto metadata(std::size_t index) const -> file_metadata;
+        [[nodiscard]] auto filename(std::size_t index) const -> std::string_view;
+        [[nodiscard]] auto source(std::size_t index) const -> std::filesystem::path;
+        [[nodiscard]] auto destination(std::size_t index) const -> std::filesystem::path;
+
+        // Materializes one operation; only this allocates per file (one string
+        // per path, moved in)
+        [[nodiscard]] auto operation(std::size_t index) const -> successful_operation;
+
+        // Lazily materialized operations, in plan order
+        [[nodiscard]] auto operations() const {
+            return std::views::iota(std::size_t{0}, ops_.size())
+                   | std::views::transform([this](const std::size_t index) {
+                         return operation(index);
+                     });
+        }
+
+        [[nodiscard]] auto to_movement_plan() const -> movement_plan;
+
+    private:
+        // Looked up by string_view, so a name already interned costs no key
+        using id_table =
+            std::unordered_map<std::string, std::uint32_t, arena::string_hash, std::equal_to<>>;
+
+        [[nodiscard]] auto intern_source_dir(std::string_view dir) -> std::uint32_t;
+
+        std::filesystem::path              root_;
+        std::vector<std::string>           bucket_names_{};
+        id_table                           bucket_ids_{};
+        std::vector<std::filesystem::path> source_dirs_{};
+        id_table                           source_dir_ids_{};
+        std::string                        names_{};
+        std::vector<compact_operation>     ops_{};
+        std::vector<file_metadata>         metadata_{};   // empty, or up to the last known
+    };
+}
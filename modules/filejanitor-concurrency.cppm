@@ -0,0 +1,72 @@
+// Module partition: concurrency
+// Exports: bounded_queue
+module;
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+export module filejanitor:concurrency;
+
+// Define and export concurrency primitives
+export namespace concurrency {
+    // Blocking multi-producer/multi-consumer FIFO with a fixed capacity. Producers
+    // wait while it is full, which is what keeps a pipeline's memory bounded.
+    // close() wakes everyone; pop() drains what is left and then yields nullopt.
+    template <typename T>
+    class bounded_queue {
+    public:
+        explicit bounded_queue(const std::size_t capacity)
+            : capacity_{std::max<std::size_t>(1, capacity)}
+        {}
+
+        // Returns false, dropping the value, once the queue has been closed
+        auto push(T&& value) -> bool {
+            auto lock{std::unique_lock{mutex_}};
+            not_full_.wait(lock, [this] { return closed_ or items_.size() < capacity_; });
+
+            if ( closed_ )
+                return false;
+
+            items_.push_back(std::move(value));
+            lock.unlock();
+            not_empty_.notify_one();
+            return true;
+        }
+
+        auto pop() -> std::optional<T> {
+            auto lock{std::unique_lock{mutex_}};
+            not_empty_.wait(lock, [this] { return closed_ or not items_.empty(); });
+
+            if ( items_.empty() )
+                return std::nullopt;
+
+            auto value{std::move(items_.front())};
+            items_.pop_front();
+            lock.unlock();
+            not_full_.notify_one();
+            return value;
+        }
+
+        auto close() -> void {
+            {
+                const auto lock{std::scoped_lock{mutex_}};
+                closed_ = true;
+            }
+            not_full_.notify_all();
+            not_empty_.notify_all();
+        }
+
+    private:
+        std::mutex              mutex_{};
+        std::condition_variable not_full_{};
+        std::condition_variable not_empty_{};
+        std::deque<T>           items_{};
+        std::size_t             capacity_;
+        bool                    closed_{false};
+    };
+}
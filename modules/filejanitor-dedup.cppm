@@ -0,0 +1,69 @@
+// Module partition: dedup
+// Exports: duplicate_action, dedup_options, duplicate, duplicate_set,
+//          find_duplicates(), without_duplicates(), link_duplicates()
+// Depends on: compact_plan, execution_report, safe_fs
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+export module filejanitor:dedup;
+
+// Re-export dependency partitions
+export import :compact_plan;
+export import :execution_report;
+export import :safe_fs;
+
+// Declare and export the duplicate detection stage between planner and executor
+export namespace fs_ops::dedup {
+    // skip:      duplicates stay where they are and drop out of the plan
+    // hard_link: every name is still moved, but each duplicate is first replaced
+    //            with a hard link to its original, so the bytes are stored once
+    enum class duplicate_action : std::int8_t {
+        skip,
+        hard_link,
+    };
+
+    struct dedup_options {
+        std::size_t      worker_count{0};   // stat and hash threads, 0 = hardware
+        duplicate_action action{duplicate_action::skip};
+        std::uint64_t    min_size{1};       // smaller files are never compared
+    };
+
+    // Indices into the plan find_duplicates was given. original is the first
+    // operation, in plan order, holding the same bytes; the stamps are both
+    // files as they were when hashed.
+    struct duplicate {
+        std::size_t         index{0};
+        std::size_t         original{0};
+        safe_fs::file_stamp stamp{};
+        safe_fs::file_stamp original_stamp{};
+    };
+
+    struct duplicate_set {
+        std::vector<duplicate> duplicates{};        // ordered by index
+        std::uint64_t          duplicate_bytes{0};  // what removing them would free
+        std::size_t            files_hashed{0};
+        std::uint64_t          bytes_hashed{0};
+    };
+
+    // Stats every source once and groups them by size; only files sharing a size
+    // with another are read, with XXH3-128 over large sequential reads on
+    // worker_count threads. Names of one (device, inode) (existing hard links)
+    // count as one file, and files that cannot be read are never reported.
+    [[nodiscard]] auto find_duplicates(const compact_plan& plan, const dedup_options& options)
+        -> duplicate_set;
+
+    // The plan without its duplicates, same order otherwise (duplicate_action::skip)
+    [[nodiscard]] auto without_duplicates(const compact_plan& plan, const duplicate_set& found)
+        -> compact_plan;
+
+    // Replaces each duplicate's source with a hard link to its original's
+    // (duplicate_action::hard_link), before the plan runs. Each pair is compared
+    // byte for byte first; one where either file changed since it was hashed,
+    // or whose bytes differ, is left alone and reported as a failure
+    // (operation_canceled). Failures name the original as their destination.
+    [[nodiscard]] auto link_duplicates(const compact_plan& plan, const duplicate_set& found)
+        -> executor::execution_report;
+}
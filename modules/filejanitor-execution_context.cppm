@@ -0,0 +1,123 @@
+// Module partition: execution_context
+// Exports: max_candidate_index, candidate_name(), directory_names, execution_context
+// Depends on: arena, fs_ops, result_types, safe_fs
+module;
+
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+export module filejanitor:execution_context;
+
+// Re-export dependency partitions
+export import :arena;
+export import :fs_ops;
+export import :result_types;
+export import :safe_fs;
+
+// Define and export the executor's per-run caches
+export namespace fs_ops::executor {
+    // "(N)" suffixes are tried from 1 up to, but not including, this index
+    inline constexpr int max_candidate_index{100};
+
+    // target's "stem (N).ext" sibling
+    [[nodiscard]] auto candidate_name(const std::filesystem::path& target, int index)
+        -> std::filesystem::path;
+
+    // Names present in one destination directory, read with a single listing the
+    // first time a collision happens there and kept current as moves land in it.
+    // Candidates are then probed in memory instead of with a stat each.
+    class directory_names {
+    public:
+        [[nodiscard]] static auto load(
+            const std::filesystem::path& dir,
+            std::pmr::memory_resource*   memory = nullptr
+        ) -> directory_names;
+
+        // If the listing was cut short, a name missing from the cache may still
+        // exist on disk, so those probes fall back to a stat
+        [[nodiscard]] auto is_free(std::string_view name) const -> bool;
+
+        auto insert(std::string_view name) -> void;
+
+        // Lazily walks "stem (N).ext" candidates, resuming after the last index
+        // handed out for this target name, and claims the first free one
+        [[nodiscard]] auto claim_candidate(const std::filesystem::path& target)
+            -> std::optional<std::filesystem::path>;
+
+    private:
+        directory_names(std::filesystem::path dir, std::pmr::memory_resource* memory);
+
+        std::filesystem::path  dir_;
+        arena::string_set      names_;
+        arena::string_map<int> next_index_;
+        bool                   complete_{true};
+    };
+
+    // State shared by every operation one executor thread runs: which bucket
+    // directories exist, their open handles and those of the source directories,
+    // and the name cache of each destination directory.
+    // Not thread-safe; parallel executors give every shard its own. The caches,
+    // one name per entry of every listed directory, come out of memory (a
+    // run_arena, or the heap when null), which must outlive the context. Open
+    // handles are bounded and churn, so they live on the heap.
+    class execution_context {
+    public:
+        using directory_ref = std::shared_ptr<const safe_fs::directory_handle>;
+
+        // Directories kept open per context; every parallel shard has its own
+        static constexpr std::size_t max_open_handles{64};
+
+        explicit execution_context(std::pmr::memory_resource* memory = nullptr);
+
+        execution_context(const execution_context&)                    = delete;
+        auto operator=(const execution_context&) -> execution_context& = delete;
+
+        execution_context(execution_context&&)                    = default;
+        auto operator=(execution_context&&) -> execution_context& = default;
+        ~execution_context()                                      = default;
+
+        // Every operation of a bucket shares one parent directory, so it is created
+        // on the bucket's first operation only. Failures are not cached; the next
+        // operation of that bucket simply tries again.
+        [[nodiscard]] auto ensure_bucket(const successful_operation& op) -> VoidResult;
+
+        // Returns target itself when it is free, otherwise the first free
+        // "stem (N).ext" sibling (or target again if all 99 are taken)
+        [[nodiscard]] auto resolve_collision(const std::filesystem::path& target)
+            -> std::filesystem::path;
+
+        // The (lazily listed) name cache of one destination directory
+        [[nodiscard]] auto names_for(const std::filesystem::path& dir) -> directory_names&;
+
+        // Opens dir on first use and keeps the max_open_handles most recently
+        // used directories open, so the kernel resolves a path once per run of
+        // files rather than once per file. An evicted handle stays open until
+        // its last holder lets go. On EMFILE every cached handle nobody holds
+        // is closed and the open retried once.
+        [[nodiscard]] auto handle_for(const std::filesystem::path& dir) -> Result<directory_ref>;
+
+        // Keeps a listed directory's name cache current after a move landed at
+        // target by some route other than resolve_collision
+        auto record_arrival(const std::filesystem::path& target) -> void;
+
+    private:
+        // Most recently used first
+        using handle_list = std::list<std::pair<std::string, directory_ref>>;
+
+        auto cache_handle(std::string key, directory_ref handle) -> directory_ref;
+
+        std::pmr::memory_resource*                            memory_;
+        arena::string_set                                     ready_buckets_;
+        handle_list                                           handle_order_;
+        std::unordered_map<std::string, handle_list::iterator> handles_;
+        arena::string_map<directory_names>                    directories_;
+    };
+}
@@ -1,9 +1,11 @@
 // Module partition: execution_report
-// Exports: execution_report class
+// Exports: execution_report, report_collector classes
 // Depends on: fs_ops
 module;
 
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <span>
 #include <utility>
 #include <vector>
@@ -38,11 +40,41 @@ export namespace fs_ops::executor {
         }
 
         template <typename Self>
-        auto with_failure(this Self&& self, const failed_operation& failure) noexcept -> Self&& {
+        auto with_failure(this Self&& self, const failed_operation& failure) -> Self&& {
             self.failures_.push_back(failure);
             return std::forward<Self>(self);
         }
 
+        // Takes the failure's paths over instead of copying them
+        template <typename Self>
+        auto with_failure(this Self&& self, failed_operation&& failure) -> Self&& {
+            self.failures_.push_back(std::move(failure));
+            return std::forward<Self>(self);
+        }
+
+        // Folds another report (e.g. one batch or one worker's share) into this one
+        template <typename Self>
+        auto with_report(this Self&& self, execution_report&& other) -> Self&& {
+            self.processed_count_ += other.processed_count_;
+            self.success_count_ += other.success_count_;
+            self.failures_.insert(
+                self.failures_.end(),
+                std::make_move_iterator(other.failures_.begin()),
+                std::make_move_iterator(other.failures_.end())
+            );
+            return std::forward<Self>(self);
+        }
+
+        // Counts carried over from a report another run wrote out (see
+        // read_report_file), on top of whatever this one already holds
+        template <typename Self>
+        auto with_counts(this Self&& self, const int processed, const int succeeded) noexcept
+            -> Self&& {
+            self.processed_count_ += processed;
+            self.success_count_ += succeeded;
+            return std::forward<Self>(self);
+        }
+
         template <typename Self>
         auto finalize(this Self&& self) noexcept -> execution_report {
             return std::forward<Self>(self);
@@ -55,4 +87,37 @@ export namespace fs_ops::executor {
         int processed_count_{0};
         int success_count_{0};
     };
+
+    // One report per worker (or shard), each on its own cache line, so parallel
+    // workers never share a counter or a failure list while they run. Slots are
+    // folded together once, in slot order, when everything is done.
+    class report_collector {
+    public:
+        explicit report_collector(const std::size_t slots)
+            : slots_(slots)
+        {}
+
+        // Only ever touched by the one thread that owns slot idx
+        [[nodiscard]] auto slot(const std::size_t idx) noexcept -> execution_report& {
+            return slots_[idx].report;
+        }
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return slots_.size(); }
+
+        [[nodiscard]] auto merge() && -> execution_report {
+            auto merged{execution_report::start()};
+            for ( auto& padded : slots_ )
+                merged = std::move(merged).with_report(std::move(padded.report)).finalize();
+            return merged;
+        }
+
+    private:
+        static constexpr std::size_t cache_line_size{64};
+
+        struct alignas(cache_line_size) padded_report {
+            execution_report report{execution_report::start()};
+        };
+
+        std::vector<padded_report> slots_;
+    };
 }
@@ -1,13 +1,158 @@
 // Module partition: executor
-// Exports: execute_plan()
-// Depends on: execution_report, movement_plan (transitively: fs_ops)
+// Exports: execution_backend, execution_options, execute_plan(), dry_run_result,
+//          dry_run()
+// Depends on: compact_plan, plan_file, journal, async, execution_context,
+//             execution_report, movement_plan (transitively: fs_ops)
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
 export module filejanitor:executor;
 
 // Re-export dependency partitions
+export import :compact_plan;
+export import :plan_file;
+export import :journal;
+export import :async;
+export import :execution_context;
 export import :execution_report;
 export import :movement_plan;
 
-// Declare and export executor function
+import :concurrency;
+
+// Declare and export executor functions
 export namespace fs_ops::executor {
+    // blocking: one rename (plus a first-use mkdir) per operation through safe_fs.
+    // io_uring: mkdirat/renameat submitted in large batches against pre-opened
+    // directory descriptors (builds with FILEJANITOR_ENABLE_IO_URING). renameat
+    // needs Linux 5.11 and mkdirat 5.15; the opcodes are probed, bucket
+    // directories are created blocking without mkdirat, and the whole plan
+    // runs blocking without renameat or a ring.
+    enum class execution_backend : std::int8_t {
+        blocking,
+        io_uring,
+    };
+
+    // cross_device: a move that rename() refuses with EXDEV (the bucket is on
+    // another filesystem) is done as copy-then-unlink instead of failing. Files
+    // of at least large_file_bytes are copied on a separate pool of
+    // transfer_workers threads, so the renames behind them keep going.
+    // The io_uring backend copies its EXDEV moves one by one once the rename
+    // batches are done, all on the calling thread. memory backs the name
+    // caches of every executor context (null = the heap), and must outlive
+    // the call.
+    // A journal (compact and mapped plans only) records every completed move
+    // and skips what it already lists; journaled runs use the blocking backend
+    // and copy cross-device files inline.
+    struct execution_options {
+        std::size_t                worker_count{0};   // 0 = hardware concurrency
+        execution_backend          backend{execution_backend::blocking};
+        bool                       cross_device{false};
+        std::uint64_t              large_file_bytes{16U * 1024U * 1024U};
+        std::size_t                transfer_workers{2};
+        std::pmr::memory_resource* memory{nullptr};   // e.g. a run_arena
+        journal::journal_writer*   journal{nullptr};
+    };
+
     [[nodiscard]] auto execute_plan(const movement_plan& plan) -> execution_report;
+
+    // Shards the plan by bucket_name and runs shards on worker_count threads.
+    // Each shard has its own bucket and collision caches; per-shard reports are
+    // merged in plan order. With one worker (or one bucket) this is execute_plan.
+    [[nodiscard]] auto execute_plan(const movement_plan& plan, const execution_options& options)
+        -> execution_report;
+
+    // Same as above, materializing each operation from the compact tables only
+    // as it runs, so the full movement_plan never exists in memory at once
+    [[nodiscard]] auto execute_plan(const compact_plan& plan) -> execution_report;
+    [[nodiscard]] auto execute_plan(const compact_plan& plan, const execution_options& options)
+        -> execution_report;
+
+    // Runs on the calling thread with a caller-owned context, so bucket, handle
+    // and name caches carry over from one plan to the next (e.g. watch batches)
+    [[nodiscard]] auto execute_plan(const compact_plan& plan, execution_context& context)
+        -> execution_report;
+
+    // Runs a plan file in place; paths are built only for operations that move
+    [[nodiscard]] auto execute_plan(const mapped_plan& plan, const execution_options& options)
+        -> execution_report;
+
+    // Every operation as a coroutine on loop, up to loop.max_in_flight() of them
+    // suspended on their rename at once. They all resume on the thread running
+    // the loop and share one context. cross_device, memory and journal apply as
+    // above; threads and backend are the loop's. Under collisions the "(N)" a
+    // file gets, like the order failures are listed in, may differ from a
+    // blocking run. plan, options and loop must outlive the task.
+    [[nodiscard]] auto execute_plan(
+        const compact_plan&      plan,
+        const execution_options& options,
+        async::io_loop&          loop
+    ) -> async::task<execution_report>;
+    [[nodiscard]] auto execute_plan(
+        const mapped_plan&       plan,
+        const execution_options& options,
+        async::io_loop&          loop
+    ) -> async::task<execution_report>;
+
+    // resolved holds every operation in plan order, with the destination it would
+    // end up at; operations that would fail keep their intended destination and
+    // are listed in report
+    struct dry_run_result {
+        movement_plan    resolved;
+        execution_report report;
+    };
+
+    // execute_plan against an in-memory model of the destination directories:
+    // each one is listed once, on its first operation, and moves land in that
+    // listing instead of on disk. Final names, "(N)" suffixes included, come out
+    // exactly as execute_plan would pick them, without a single mutating syscall.
+    // Shards by bucket like execute_plan; backend and cross-device settings are
+    // ignored, and source-side failures (a vanished or locked file) are not
+    // modelled.
+    [[nodiscard]] auto dry_run(const compact_plan& plan, const execution_options& options)
+        -> dry_run_result;
+    [[nodiscard]] auto dry_run(const mapped_plan& plan, const execution_options& options)
+        -> dry_run_result;
+}
+
+// Backend entry points shared between executor translation units, not exported
+namespace fs_ops::executor::detail {
+    [[nodiscard]] auto execute_with_io_uring(const movement_plan& plan, const execution_options& options)
+        -> execution_report;
+
+    // Copy-then-unlink for a move between filesystems. The source is only
+    // unlinked once the copy is verified against it and synced to disk; if that
+    // fails the copy is removed, so exactly one of the two files is left either
+    // way, crash included.
+    [[nodiscard]] auto move_across_devices(
+        const std::filesystem::path& from,
+        const std::filesystem::path& to
+    ) -> VoidResult;
+
+    // Worker threads doing cross-device moves off the executor threads. submit()
+    // blocks while `capacity` moves are queued, bounding the backlog. Each op's
+    // destination must already be collision-free.
+    class transfer_pool {
+    public:
+        transfer_pool(std::size_t workers, std::size_t capacity);
+
+        transfer_pool(const transfer_pool&)                    = delete;
+        auto operator=(const transfer_pool&) -> transfer_pool& = delete;
+        ~transfer_pool();
+
+        auto submit(successful_operation&& op) -> void;
+
+        // Waits for every submitted move and reports them. Call once, last.
+        [[nodiscard]] auto drain() -> execution_report;
+
+    private:
+        concurrency::bounded_queue<successful_operation> queue_;
+        report_collector                                 reports_;
+        std::vector<std::jthread>                        workers_{};
+    };
 }
@@ -0,0 +1,27 @@
+// Module partition: extension
+// Exports: extension_of(), ascii_lowercase(), normalize_extension()
+module;
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+export module filejanitor:extension;
+
+// Declare and export extension helpers used by the planner
+export namespace fs_ops::planner {
+    // The std::filesystem::path::extension() of a path's generic text, as a view
+    // into it: from the last '.' of the final component, except that a leading
+    // dot (".bashrc") or the special names "." and ".." have none.
+    [[nodiscard]] auto extension_of(std::string_view path) noexcept -> std::string_view;
+
+    // Lowercases ASCII letters of `text` into `out` (same length), eight bytes at
+    // a time. Bytes >= 0x80 are copied unchanged, as std::tolower does in the
+    // "C" locale, so UTF-8 names pass through intact.
+    auto ascii_lowercase(std::string_view text, char* out) noexcept -> void;
+
+    // Lowercased extension including its dot, or empty. Builds no intermediate
+    // path or string, so extensions that fit the small-string buffer (virtually
+    // all of them) cost no allocation.
+    [[nodiscard]] auto normalize_extension(const std::filesystem::path& path) -> std::string;
+}
@@ -1,5 +1,6 @@
 // Module partition: fs_ops
-// Exports: scanned_file, candidate, operation_status, successful_operation, failed_operation
+// Exports: file_metadata, scanned_file, candidate, operation_status, successful_operation,
+//          failed_operation
 module;
 
 #include <cstdint>
@@ -11,9 +12,24 @@ export module filejanitor:fs_ops;
 
 // Define and export types directly in the module
 export namespace fs_ops {
+    // What a scan learned of a regular file, so no later phase stats it again.
+    // Every collected file is regular or a symlink to one, so symlink is all
+    // there is to its type; inode, size and mtime are then the target's.
+    // known is false where the scan asked for nothing (the default); device and
+    // inode are 0 where the platform has none.
+    struct file_metadata {
+        std::uint64_t device{0};
+        std::uint64_t inode{0};
+        std::uint64_t size{0};
+        std::int64_t  mtime_ns{0};
+        bool          symlink{false};
+        bool          known{false};
+    };
+
     struct scanned_file {
         std::filesystem::path path;
         std::string           extension;
+        file_metadata         metadata{};
     };
 
     struct candidate {
@@ -26,12 +42,14 @@ export namespace fs_ops {
         failure,
         success,
         skipped,
+        deferred,   // handed to another worker, which reports it itself
     };
 
     struct successful_operation {
         std::filesystem::path source;
         std::filesystem::path destination;
         std::string           bucket_name;
+        file_metadata         metadata{};   // of source, as scanned
     };
 
     struct failed_operation {
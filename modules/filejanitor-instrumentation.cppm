@@ -0,0 +1,107 @@
+// Module partition: instrumentation
+// Exports: enabled, counter, phase, phase_stats, count(), scoped_phase, totals(),
+//          allocations(), to_json()
+module;
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+export module filejanitor:instrumentation;
+
+// Define and export the instrumentation hooks
+export namespace instrumentation {
+    // Builds configured with FILEJANITOR_ENABLE_INSTRUMENTATION define
+    // FILEJANITOR_INSTRUMENTATION. Without it every hook below compiles away and
+    // no allocation function is replaced.
+#if defined(FILEJANITOR_INSTRUMENTATION)
+    inline constexpr bool enabled{true};
+#else
+    inline constexpr bool enabled{false};
+#endif
+
+    // Calls issued through safe_fs (any backend), plus collision candidate probes
+    enum class counter : std::uint8_t {
+        exists_calls,
+        stat_calls,
+        rename_calls,
+        mkdir_calls,
+        copy_calls,
+        link_calls,
+        collision_probes,
+    };
+    inline constexpr std::size_t counter_count{7};
+
+    enum class phase : std::uint8_t {
+        scan,
+        plan,
+        dedup,
+        execute,
+    };
+    inline constexpr std::size_t phase_count{4};
+
+    // Totals over every time a phase was entered. cpu_ns is process CPU time
+    // (all threads); allocations count every thread's operator new calls.
+    struct phase_stats {
+        std::uint64_t wall_ns{0};
+        std::uint64_t cpu_ns{0};
+        std::uint64_t bytes_allocated{0};
+        std::uint64_t allocations{0};
+    };
+}
+
+// Storage behind the hooks, defined in instrumentation.cxx; not exported
+namespace instrumentation::detail {
+    struct resource_sample {
+        std::uint64_t wall_ns{0};
+        std::uint64_t cpu_ns{0};
+        std::uint64_t bytes_allocated{0};
+        std::uint64_t allocations{0};
+    };
+
+    [[nodiscard]] auto counter_slot(counter which) noexcept -> std::atomic<std::uint64_t>&;
+    [[nodiscard]] auto sample() noexcept -> resource_sample;
+    auto add_phase(phase which, const resource_sample& start) noexcept -> void;
+}
+
+export namespace instrumentation {
+    // Relaxed: counters are only read back after the work they count is done
+    inline auto count(const counter which, const std::uint64_t n = 1) noexcept -> void {
+        if constexpr ( enabled )
+            detail::counter_slot(which).fetch_add(n, std::memory_order_relaxed);
+    }
+
+    // Adds the time and allocations between construction and destruction to
+    // one phase
+    class scoped_phase {
+    public:
+        explicit scoped_phase(const phase which) noexcept
+            : which_{which},
+              start_{enabled ? detail::sample() : detail::resource_sample{}}
+        {}
+
+        scoped_phase(const scoped_phase&)                    = delete;
+        auto operator=(const scoped_phase&) -> scoped_phase& = delete;
+
+        ~scoped_phase() {
+            if constexpr ( enabled )
+                detail::add_phase(which_, start_);
+        }
+
+    private:
+        phase                   which_;
+        detail::resource_sample start_;
+    };
+
+    [[nodiscard]] auto counter_value(counter which) noexcept -> std::uint64_t;
+    [[nodiscard]] auto totals(phase which) noexcept -> phase_stats;
+
+    // operator new calls so far, on every thread and in or out of a phase;
+    // always 0 without FILEJANITOR_INSTRUMENTATION
+    [[nodiscard]] auto allocations() noexcept -> std::uint64_t;
+
+    // {"enabled":..,"phases":{"scan":{..},..},"counters":{"exists_calls":..,..}}
+    // with a stable key order, for diffing runs across versions
+    [[nodiscard]] auto to_json() -> std::string;
+}
@@ -0,0 +1,137 @@
+// Module partition: journal
+// Exports: journal_options, journal_entry, journal_contents, read_journal(),
+//          plan_fingerprint(), open_plan(), journal_writer class, reconcile(),
+//          undo()
+// Depends on: plan_file, execution_report, result_types
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+export module filejanitor:journal;
+
+// Re-export dependency partitions
+export import :plan_file;
+export import :execution_report;
+export import :result_types;
+
+// Declare and export the write-ahead journal of executed plan files
+export namespace fs_ops::journal {
+    // Records collect in memory and go out in one write() per batch_records;
+    // every sync_every records the file is also fdatasync'd. A record follows
+    // its move, so a killed process loses the records of up to one batch of
+    // moves that did happen, a power failure those of the unsynced ones.
+    // reconcile() finds those moves again before a resume or an undo.
+    struct journal_options {
+        std::size_t batch_records{256};
+        std::size_t sync_every{8192};
+    };
+
+    // One completed move: its plan index and, when a collision sent it to a
+    // "(N)" sibling, the name it landed under (empty = its planned name)
+    struct journal_entry {
+        std::uint64_t index{0};
+        std::string   final_name{};
+    };
+
+    struct journal_contents {
+        std::filesystem::path      plan_file{};
+        std::uint64_t              fingerprint{0};    // of plan_file's bytes
+        std::uint64_t              op_count{0};
+        std::vector<journal_entry> entries{};         // in completion order
+        std::uint64_t              intact_bytes{0};   // up to the last whole record
+        std::size_t                recovered{0};      // trailing entries not on disk
+    };
+
+    // Layout (native byte order): a header with the plan's op count,
+    // fingerprint and absolute path, then one {u64 index, u32 name length,
+    // name} record per move. A torn record at the end is left out.
+    [[nodiscard]] auto read_journal(const std::filesystem::path& file) -> Result<journal_contents>;
+
+    // XXH3-64 over a plan file, which ties a journal to the exact plan it indexes
+    [[nodiscard]] auto plan_fingerprint(const std::filesystem::path& plan_file) -> Result<std::uint64_t>;
+
+    // Maps the journal's plan, refusing one changed since the journal was
+    // started (bad_message)
+    [[nodiscard]] auto open_plan(const journal_contents& journal) -> Result<mapped_plan>;
+
+    // Appends the moves of a running plan. record() may be called from every
+    // executor worker at once. Move-only; syncs and closes on destruction.
+    class journal_writer {
+    public:
+        // A new journal for plan_file, replacing file
+        [[nodiscard]] static auto create(
+            const std::filesystem::path& file,
+            const std::filesystem::path& plan_file,
+            const mapped_plan&           plan,
+            journal_options              options = {}
+        ) -> Result<journal_writer>;
+
+        // Continues a journal read by read_journal: its torn tail is cut off,
+        // the entries reconcile() recovered are appended, and done() holds for
+        // every operation it lists
+        [[nodiscard]] static auto resume(
+            const std::filesystem::path& file,
+            const journal_contents&      contents,
+            journal_options              options = {}
+        ) -> Result<journal_writer>;
+
+        journal_writer(const journal_writer&)                    = delete;
+        auto operator=(const journal_writer&) -> journal_writer& = delete;
+        journal_writer(journal_writer&& other) noexcept;
+        auto operator=(journal_writer&& other) noexcept -> journal_writer&;
+        ~journal_writer();
+
+        auto record(std::size_t index, std::string_view final_name) -> void;
+
+        // Completed by an earlier run; fixed at resume(), so reads need no lock
+        [[nodiscard]] auto done(std::size_t index) const noexcept -> bool;
+        [[nodiscard]] auto resumed_count() const noexcept -> std::size_t;
+
+        // Writes and syncs what is batched, then reports the first error any
+        // write so far ran into
+        [[nodiscard]] auto sync() -> VoidResult;
+
+    private:
+        journal_writer(std::FILE* file, journal_options options) noexcept;
+
+        // Both expect mutex_ to be held
+        auto write_batch() -> void;
+        auto sync_file() -> void;
+
+        std::FILE*        file_{nullptr};
+        journal_options   options_{};
+        std::string       batch_{};
+        std::size_t       batched_{0};
+        std::size_t       unsynced_{0};
+        std::error_code   error_{};
+        std::vector<bool> done_{};
+        std::size_t       resumed_{0};
+        std::mutex        mutex_{};
+    };
+
+    // Finds the moves of a killed run that never made it into its journal: an
+    // operation that is not listed, whose source is gone, and whose planned
+    // destination or one of its "(N)" siblings is the source the plan scanned
+    // (same device and inode, not claimed by a listed entry) is taken as done
+    // and appended to entries. Returns how many. Plans written without scan
+    // metadata recover nothing, nor do moves that had to copy across devices
+    // or symlinks whose target no longer resolves from their new place.
+    [[nodiscard]] auto reconcile(journal_contents& journal, const mapped_plan& plan) -> std::size_t;
+
+    // Moves every journaled operation back to its source, newest first. A
+    // source name taken again since is never replaced (file_exists), and moves
+    // that crossed filesystems are copied back. An entry whose landed file is
+    // gone and whose source exists counts as undone already, so an undo cut
+    // short can simply be run again. Failures name the landed file as their
+    // source.
+    [[nodiscard]] auto undo(const journal_contents& journal, const mapped_plan& plan)
+        -> executor::execution_report;
+}
@@ -0,0 +1,56 @@
+// Module partition: multi_root
+// Exports: read_manifest(), root_options, root_result, run_roots()
+// Depends on: scanner, planner, executor, result_types
+module;
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <system_error>
+#include <vector>
+
+export module filejanitor:multi_root;
+
+// Re-export dependency partitions
+export import :scanner;
+export import :planner;
+export import :executor;
+export import :result_types;
+
+// Declare and export the driver that runs many roots in one process
+export namespace fs_ops::multi_root {
+    // One root per line; blank lines and lines starting with '#' are skipped,
+    // surrounding whitespace is trimmed. Relative roots are taken from the
+    // manifest's own directory, so a manifest can travel with its trees.
+    [[nodiscard]] auto read_manifest(const std::filesystem::path& file)
+        -> Result<std::vector<std::filesystem::path>>;
+
+    // scan, planning and execution apply to every root as they would to a
+    // single run, except that their memory is replaced (see run_roots) and
+    // execution.journal is ignored: a journal belongs to exactly one plan.
+    struct root_options {
+        std::size_t                 worker_count{0};   // roots at once, 0 = hardware concurrency
+        scanner::scan_options       scan{};
+        planner::planning_options   planning{};
+        executor::execution_options execution{};
+    };
+
+    struct root_result {
+        std::filesystem::path      root{};
+        std::error_code            error{};   // the root is missing or not a directory
+        std::size_t                files_scanned{0};
+        std::size_t                scan_errors{0};
+        executor::execution_report report{executor::execution_report::start()};
+    };
+
+    // Scans, plans and executes every root as one job on a pool of worker_count
+    // threads, each root still using the scan, plan and execute threads its
+    // options ask for. The roots share one parsed rule set (planning.rules)
+    // and the process-wide counters; bookkeeping goes into a run arena per
+    // root instead, released as soon as that root is done, so a long list of
+    // roots never piles up in memory. Results come back in roots order.
+    [[nodiscard]] auto run_roots(
+        std::span<const std::filesystem::path> roots,
+        const root_options&                    options
+    ) -> std::vector<root_result>;
+}
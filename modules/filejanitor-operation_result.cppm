@@ -3,11 +3,7 @@
 // Depends on: fs_ops
 module;
 
-#include <filesystem>
-#include <functional>
-#include <optional>
 #include <system_error>
-#include <utility>
 
 export module filejanitor:operation_result;
 
@@ -16,31 +12,26 @@ export import :fs_ops;
 
 // Define and export operation_result class
 export namespace fs_ops {
+    // Outcome of one operation: its status and, for a failure, the error. The
+    // operation itself stays with the caller, which hands its paths over to the
+    // report only when it actually failed, so the success path copies nothing.
     class operation_result {
     public:
         operation_result() = delete;
 
-        static auto create_success() -> operation_result;
-        static auto create_failure(const successful_operation& o, std::error_code ec) -> operation_result;
-        static auto create_skipped() -> operation_result;
+        static auto create_success() noexcept -> operation_result;
+        static auto create_failure(std::error_code ec) noexcept -> operation_result;
+        static auto create_skipped() noexcept -> operation_result;
+        static auto create_deferred() noexcept -> operation_result;
 
-        [[nodiscard]] auto status() const -> operation_status;
-        [[nodiscard]] auto failure() const -> std::optional<std::reference_wrapper<const failed_operation>>;
+        [[nodiscard]] auto status() const noexcept -> operation_status;
+        // Empty unless status() is failure
+        [[nodiscard]] auto error() const noexcept -> std::error_code;
 
     private:
-        failed_operation failure_{};
+        std::error_code  error_{};
         operation_status status_{};
 
-        explicit operation_result(operation_status status);
-
-        template <typename Self>
-        auto with_failure(this Self&& self, const successful_operation& op, std::error_code ec) -> operation_result {
-            self.failure_ = failed_operation{
-                .source{op.source},
-                .destination{op.destination},
-                .error{ec}
-            };
-            return std::forward<Self>(self);
-        }
+        explicit operation_result(operation_status status, std::error_code ec = {}) noexcept;
     };
 }
@@ -0,0 +1,68 @@
+// Module partition: output
+// Exports: output_mode, print_plan(), print_resolved(), print_report(), ndjson_log class
+// Depends on: compact_plan, movement_plan, execution_report, result_types
+module;
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+export module filejanitor:output;
+
+// Re-export dependency partitions
+export import :compact_plan;
+export import :movement_plan;
+export import :execution_report;
+export import :result_types;
+
+// Declare and export console and log reporting
+export namespace output {
+    // quiet:   nothing but errors on stderr
+    // summary: counts only
+    // sampled: counts plus a bounded, evenly spaced selection of lines
+    // full:    one line per planned operation and per failure
+    enum class output_mode : std::int8_t {
+        quiet,
+        summary,
+        sampled,
+        full,
+    };
+
+    // [PLAN] lines, formatted into one reusable buffer and written to stdout in
+    // large chunks. Destinations are assembled from per-bucket prefixes, so no
+    // path is built per operation.
+    auto print_plan(const fs_ops::compact_plan& plan, output_mode mode) -> void;
+
+    // [DRY RUN] lines with the final names a dry run resolved, in the same
+    // buffered, sampled way; operations that stay in place are left out
+    auto print_resolved(const fs_ops::movement_plan& plan, output_mode mode) -> void;
+
+    auto print_report(const fs_ops::executor::execution_report& report, output_mode mode)
+        -> void;
+
+    // Structured log, one JSON object per line ("event": "plan", "failure" or
+    // "summary"), for log pipelines. Paths are written as their native bytes.
+    class ndjson_log {
+    public:
+        [[nodiscard]] static auto open(const std::filesystem::path& file) -> Result<ndjson_log>;
+
+        ndjson_log(const ndjson_log&)                    = delete;
+        auto operator=(const ndjson_log&) -> ndjson_log& = delete;
+        ndjson_log(ndjson_log&& other) noexcept;
+        auto operator=(ndjson_log&& other) noexcept -> ndjson_log&;
+        ~ndjson_log();
+
+        auto write_plan(const fs_ops::compact_plan& plan) -> void;
+        auto write_report(const fs_ops::executor::execution_report& report) -> void;
+
+    private:
+        explicit ndjson_log(std::FILE* file) noexcept;
+
+        auto flush_if_full() -> void;
+        auto flush() -> void;
+
+        std::FILE*  file_{nullptr};
+        std::string buffer_{};
+    };
+}
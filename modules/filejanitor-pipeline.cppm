@@ -0,0 +1,37 @@
+// Module partition: pipeline
+// Exports: pipeline_options, pipeline_result, run_pipeline()
+// Depends on: execution_report, planner
+module;
+
+#include <cstddef>
+#include <filesystem>
+
+export module filejanitor:pipeline;
+
+// Re-export dependency partition
+export import :execution_report;
+export import :planner;
+
+// Declare and export the streaming scan -> plan -> execute driver
+export namespace fs_ops::pipeline {
+    struct pipeline_options {
+        std::size_t batch_size{4096};   // files per scan batch / per plan
+        std::size_t queue_depth{4};     // batches buffered between two stages
+        planner::planning_options planning{};   // applied to every batch
+    };
+
+    struct pipeline_result {
+        executor::execution_report report;
+        std::size_t                files_scanned{0};
+        std::size_t                scan_errors{0};
+    };
+
+    // Scans the root on one thread, plans each batch on another and executes plans
+    // on the calling thread as they arrive. At most queue_depth batches wait
+    // between any two stages, so memory is bounded by batch_size, not by the
+    // size of the directory.
+    [[nodiscard]] auto run_pipeline(
+        const std::filesystem::path& root_path,
+        const pipeline_options&      options
+    ) -> pipeline_result;
+}
@@ -0,0 +1,104 @@
+// Module partition: plan_file
+// Exports: write_plan_file(), mapped_plan class
+// Depends on: compact_plan, result_types (transitively: movement_plan, fs_ops)
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ranges>
+#include <string_view>
+#include <vector>
+
+export module filejanitor:plan_file;
+
+// Re-export dependency partitions
+export import :compact_plan;
+export import :result_types;
+
+// Declare and export the on-disk plan format
+export namespace fs_ops {
+    // Layout (little-endian, every section 8-byte aligned):
+    //   header | bucket table | source dir table | op records | string arena
+    // Tables hold {offset, length} slices of the arena, which starts with the
+    // root path. Op records mirror compact_operation with fixed-width fields,
+    // followed by the source's scan metadata (flagged unknown when not taken).
+    [[nodiscard]] auto write_plan_file(const compact_plan& plan, const std::filesystem::path& file)
+        -> VoidResult;
+
+    // A plan file mapped read-only and used in place: nothing is copied at open
+    // beyond a bounds check of every table, and paths are only built for the
+    // operations that actually run. Move-only; unmaps on destruction.
+    class mapped_plan {
+    public:
+        [[nodiscard]] static auto open(const std::filesystem::path& file) -> Result<mapped_plan>;
+
+        mapped_plan(const mapped_plan&)                    = delete;
+        auto operator=(const mapped_plan&) -> mapped_plan& = delete;
+        mapped_plan(mapped_plan&& other) noexcept;
+        auto operator=(mapped_plan&& other) noexcept -> mapped_plan&;
+        ~mapped_plan();
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t;
+        [[nodiscard]] auto empty() const noexcept -> bool;
+        [[nodiscard]] auto root() const -> std::string_view;
+        [[nodiscard]] auto bucket_count() const noexcept -> std::size_t;
+        [[nodiscard]] auto bucket_name(std::uint32_t bucket) const -> std::string_view;
+        [[nodiscard]] auto source_dir(std::uint32_t dir) const -> std::string_view;
+
+        [[nodiscard]] auto bucket_of(std::size_t index) const -> std::uint32_t;
+        // As compact_plan::metadata() said when the plan was written
+        [[nodiscard]] auto metadata(std::size_t index) const -> file_metadata;
+        [[nodiscard]] auto filename(std::size_t index) const -> std::string_view;
+        [[nodiscard]] auto source(std::size_t index) const -> std::filesystem::path;
+        [[nodiscard]] auto destination(std::size_t index) const -> std::filesystem::path;
+
+        // True when the file already sits in its bucket, decided on the mapped
+        // strings alone
+        [[nodiscard]] auto is_in_place(std::size_t index) const -> bool;
+
+        [[nodiscard]] auto operation(std::size_t index) const -> successful_operation;
+
+        [[nodiscard]] auto operations() const {
+            return std::views::iota(std::size_t{0}, size())
+                   | std::views::transform([this](const std::size_t index) {
+                         return operation(index);
+                     });
+        }
+
+        [[nodiscard]] auto to_movement_plan() const -> movement_plan;
+
+    private:
+        mapped_plan() = default;
+
+        struct slice {
+            std::uint64_t offset{0};
+            std::uint64_t length{0};
+        };
+
+        struct record {
+            std::uint64_t name_offset{0};
+            std::uint32_t name_length{0};
+            std::uint32_t source_dir{0};
+            std::uint32_t bucket{0};
+        };
+
+        [[nodiscard]] auto validate() -> bool;
+        [[nodiscard]] auto slice_at(std::size_t table_offset, std::size_t index) const -> slice;
+        [[nodiscard]] auto record_at(std::size_t index) const -> record;
+        [[nodiscard]] auto text(slice s) const -> std::string_view;
+
+        const std::byte*       data_{nullptr};
+        std::size_t            length_{0};
+        std::vector<std::byte> owned_{};   // platforms without mmap read the file here
+        std::size_t            op_count_{0};
+        std::size_t            bucket_count_{0};
+        std::size_t            source_dir_count_{0};
+        std::size_t            buckets_at_{0};
+        std::size_t            source_dirs_at_{0};
+        std::size_t            records_at_{0};
+        std::size_t            arena_at_{0};
+        std::size_t            arena_size_{0};
+        slice                  root_{};
+    };
+}
@@ -1,20 +1,68 @@
 // Module partition: planner
-// Exports: generate_plan()
-// Depends on: movement_plan (transitively: fs_ops)
+// Exports: planning_options, generate_plan(), generate_compact_plan()
+// Depends on: compact_plan, movement_plan, rules (transitively: fs_ops)
 module;
 
+#include <cstddef>
 #include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <span>
 #include <vector>
 
 export module filejanitor:planner;
 
-// Re-export dependency partition (provides movement_plan and fs_ops types)
+// Re-export dependency partitions (provide movement_plan and fs_ops types)
+export import :compact_plan;
 export import :movement_plan;
+export import :rules;
 
 // Declare and export planner function
 export namespace fs_ops::planner {
+    // Without rules every file goes to its lowercased extension's bucket (or
+    // no_extension); with them, matching files go to the rule's bucket instead.
+    // Size rules cost one stat per file the scan brought no metadata for.
+    // memory backs the decorate/group tables the planner builds and drops again
+    // (null = the heap); the plan itself is always heap-owned, since it
+    // outlives the call.
+    struct planning_options {
+        std::size_t                                    worker_count{1};   // 0 = hardware concurrency
+        std::shared_ptr<const fs_ops::rules::rule_set> rules{};
+        std::pmr::memory_resource*                     memory{nullptr};   // e.g. a run_arena
+    };
+
     [[nodiscard]] auto generate_plan(
         std::vector<std::filesystem::path>&& raw_files,
         const std::filesystem::path& root_path
     ) -> movement_plan;
+
+    // Same operations, in the same order, as generate_plan
+    [[nodiscard]] auto generate_compact_plan(
+        std::vector<std::filesystem::path>&& raw_files,
+        const std::filesystem::path& root_path
+    ) -> compact_plan;
+
+    // Decorates and groups contiguous shards of raw_files on worker_count
+    // threads, then merges the per-shard bucket tables. The plan is identical
+    // to the serial one: same buckets, same order, same operations.
+    [[nodiscard]] auto generate_plan(
+        std::vector<std::filesystem::path>&& raw_files,
+        const std::filesystem::path& root_path,
+        const planning_options& options
+    ) -> movement_plan;
+
+    [[nodiscard]] auto generate_compact_plan(
+        std::vector<std::filesystem::path>&& raw_files,
+        const std::filesystem::path& root_path,
+        const planning_options& options
+    ) -> compact_plan;
+
+    // metadata is empty, or the scan's metadata_bin for raw_files, one entry
+    // per file; each operation then carries its file's metadata along
+    [[nodiscard]] auto generate_compact_plan(
+        std::vector<std::filesystem::path>&& raw_files,
+        std::span<const file_metadata> metadata,
+        const std::filesystem::path& root_path,
+        const planning_options& options
+    ) -> compact_plan;
 }
@@ -0,0 +1,35 @@
+// Module partition: report_file
+// Exports: write_report_file(), read_report_file(), merge_report_files()
+// Depends on: execution_report, result_types
+module;
+
+#include <filesystem>
+#include <span>
+
+export module filejanitor:report_file;
+
+// Re-export dependency partitions
+export import :execution_report;
+export import :result_types;
+
+// Declare and export the on-disk execution report format
+export namespace fs_ops::executor {
+    // Layout (little-endian): a header with the processed, success and failure
+    // counts, then one {error value, error category, source length, destination
+    // length, source, destination} record per failure. Only the generic and
+    // system categories make the trip; any other error comes back as a system
+    // error with the same value.
+    [[nodiscard]] auto write_report_file(
+        const execution_report&      report,
+        const std::filesystem::path& file
+    ) -> VoidResult;
+
+    // bad_message for a truncated file or one that is not a report
+    [[nodiscard]] auto read_report_file(const std::filesystem::path& file)
+        -> Result<execution_report>;
+
+    // One report for runs made apart (shards, roots, hosts): counts are summed
+    // and failures listed in file order. Fails on the first unreadable file.
+    [[nodiscard]] auto merge_report_files(std::span<const std::filesystem::path> files)
+        -> Result<execution_report>;
+}
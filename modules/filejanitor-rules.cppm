@@ -0,0 +1,141 @@
+// Module partition: rules
+// Exports: no_match, file_facts, extension_table, rule_set class
+// Depends on: result_types
+module;
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+export module filejanitor:rules;
+
+// Re-export dependency partition
+export import :result_types;
+
+// Define and export the bucketing rule engine used by the planner
+export namespace fs_ops::rules {
+    // Bucket id returned when no rule of a shape applies
+    inline constexpr std::uint32_t no_match{std::numeric_limits<std::uint32_t>::max()};
+
+    // What a file is classified by. size is only filled in (one stat) when the
+    // rule set has size rules.
+    struct file_facts {
+        std::string_view name;        // final path component
+        std::string_view extension;   // lowercased, with its dot, or empty
+        std::uint64_t    size{0};
+    };
+
+    // Extension -> bucket id through a hash-and-displace perfect hash: keys are
+    // split into small groups, and each group gets the displacement that sends
+    // all of its keys to free slots. A lookup is one hash, one displacement,
+    // one slot and one key compare, with no probing and no chains. Keys that
+    // cannot be placed even in a table grown well past their count (64-bit
+    // hashes that collide) are kept sorted and binary searched instead.
+    class extension_table {
+    public:
+        struct entry {
+            std::string   extension;   // lowercased, with its dot, or empty
+            std::uint32_t bucket{0};
+        };
+
+        extension_table() = default;
+
+        // Later duplicates of an extension are dropped, the first one wins
+        [[nodiscard]] static auto build(const std::vector<entry>& entries) -> extension_table;
+
+        [[nodiscard]] auto find(std::string_view extension) const noexcept -> std::uint32_t;
+        [[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+
+    private:
+        struct slot {
+            std::uint32_t key_offset{0};
+            std::uint32_t key_length{0};
+            std::uint32_t bucket{no_match};
+        };
+
+        std::vector<slot>          slots_{};
+        std::vector<std::uint32_t> displacements_{};
+        std::vector<entry>         sorted_{};   // only when there are no slots_
+        std::string                keys_{};
+        std::uint64_t              group_mask_{0};
+        int                        slot_shift_{63};
+        std::size_t                size_{0};
+    };
+
+    // A rules file has one rule per line, "bucket: shape arguments", with '#'
+    // starting a comment:
+    //
+    //     images:      ext jpg jpeg png heic
+    //     documents:   ext pdf doc docx
+    //     screenshots: prefix Screenshot IMG_
+    //     huge:        size >= 1G
+    //     tiny:        size < 4K
+    //     mid:         size 1M..100M
+    //
+    // Extensions are matched case-insensitively on the last one only ("none"
+    // matches files without one); prefixes are case-sensitive; sizes take K, M
+    // and G (powers of 1024). Within a shape the first matching line wins;
+    // across shapes, prefix rules come first, then size, then extension rules.
+    // Files no rule matches keep the default extension bucket.
+    class rule_set {
+    public:
+        [[nodiscard]] static auto parse(std::string_view text) -> Result<rule_set>;
+        [[nodiscard]] static auto load(const std::filesystem::path& file) -> Result<rule_set>;
+
+        [[nodiscard]] auto bucket_count() const noexcept -> std::size_t;
+        [[nodiscard]] auto bucket_name(std::uint32_t bucket) const -> const std::string&;
+
+        [[nodiscard]] auto has_prefix_rules() const noexcept -> bool;
+        [[nodiscard]] auto has_size_rules() const noexcept -> bool;
+
+        [[nodiscard]] auto match_extension(std::string_view extension) const noexcept -> std::uint32_t;
+
+        // Candidates are indexed by first byte, so only prefixes that could
+        // match are compared
+        [[nodiscard]] auto match_prefix(std::string_view name) const noexcept -> std::uint32_t;
+
+        // The size rules are flattened into disjoint ranges at parse time; this
+        // is one binary search over their boundaries
+        [[nodiscard]] auto match_size(std::uint64_t size) const noexcept -> std::uint32_t;
+
+        // Classification specialized on the shapes a set uses: the planner
+        // picks the instantiation once per run of files, so the per-file code
+        // has no branch for a shape with no rules
+        template <bool Prefix, bool Size>
+        [[nodiscard]] auto classify(const file_facts& facts) const noexcept -> std::uint32_t {
+            if constexpr ( Prefix ) {
+                if ( const auto bucket{match_prefix(facts.name)}; bucket != no_match )
+                    return bucket;
+            }
+            if constexpr ( Size ) {
+                if ( const auto bucket{match_size(facts.size)}; bucket != no_match )
+                    return bucket;
+            }
+            return match_extension(facts.extension);
+        }
+
+    private:
+        struct prefix_rule {
+            std::string   prefix;
+            std::uint32_t bucket{0};
+        };
+
+        struct size_range {
+            std::uint64_t first{0};   // ranges cover [first, next range's first)
+            std::uint32_t bucket{no_match};
+        };
+
+        rule_set() = default;
+
+        std::vector<std::string>       buckets_{};
+        extension_table                extensions_{};
+        std::vector<prefix_rule>       prefixes_{};        // grouped by first byte
+        std::array<std::uint32_t, 257> prefix_starts_{};   // byte -> first of its rules
+        std::vector<size_range>        sizes_{};
+    };
+}
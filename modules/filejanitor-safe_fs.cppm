@@ -1,10 +1,22 @@
 // Module partition: safe_fs
-// Exports: safe_scan(), exists(), rename(), create_directories()
+// Exports: entry_type, dirent_view, file_stamp, directory_handle, safe_scan(),
+//          native_scan(), join(), entry_count_hint(), stamp(), probe(), exists(), rename(),
+//          rename_no_replace(),
+//          rename_at(),
+//          copy_file(), read_chunks(), same_contents(), link_over(), sync_file(),
+//          remove(), create_directories()
 // Depends on: result_types
 module;
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <functional>
 #include <generator>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <string_view>
 
 export module filejanitor:safe_fs;
 
@@ -13,8 +25,131 @@ export import :result_types;
 
 // Declare and export functions
 export namespace safe_fs {
-    [[nodiscard]] auto safe_scan(std::filesystem::path path) -> std::generator<ScanResult>;
+    // File type as reported by the directory listing itself (d_type). unknown
+    // means the filesystem did not say and a status query is needed.
+    enum class entry_type : std::int8_t {
+        unknown,
+        regular,
+        directory,
+        symlink,
+        other,
+    };
+
+    // One raw directory entry. `name` points into the scanner's read buffer and
+    // is only valid until the generator is resumed.
+    struct dirent_view {
+        std::string_view name;
+        entry_type       type{entry_type::unknown};
+        std::uint64_t    inode{0};
+    };
+
+    using DirentResult = Result<dirent_view>;
+
+    // What an incremental rescan compares to tell whether an entry changed.
+    // device and inode are 0 where the platform has none; an inode number only
+    // names a file together with its device.
+    struct file_stamp {
+        entry_type    type{entry_type::unknown};
+        std::uint64_t device{0};
+        std::uint64_t inode{0};
+        std::uint64_t size{0};
+        std::int64_t  mtime_ns{0};
+
+        auto operator==(const file_stamp&) const -> bool = default;
+    };
+
+    // Owning wrapper around an open directory descriptor, for the *at() family
+    // of calls. Only Linux can open one; elsewhere open() reports not_supported.
+    class directory_handle {
+    public:
+        [[nodiscard]] static auto open(const std::filesystem::path& path) -> Result<directory_handle>;
+
+        directory_handle(const directory_handle&)                    = delete;
+        auto operator=(const directory_handle&) -> directory_handle& = delete;
+        directory_handle(directory_handle&& other) noexcept;
+        auto operator=(directory_handle&& other) noexcept -> directory_handle&;
+        ~directory_handle();
+
+        [[nodiscard]] auto native() const noexcept -> int;
+
+    private:
+        explicit directory_handle(int fd) noexcept;
+
+        int fd_{-1};
+    };
+
+    // Yields one entry object, reassigned in place for every directory entry so
+    // its path keeps its buffer; the reference is only valid until the generator
+    // is resumed. Copy the path out to keep it.
+    [[nodiscard]] auto safe_scan(std::filesystem::path path) -> std::generator<const ScanResult&>;
+
+    // Lightweight listing backend: on Linux, getdents64 into one reusable buffer,
+    // with no directory_entry or path built per entry and "." / ".." dropped.
+    // Elsewhere it falls back to directory_iterator.
+    [[nodiscard]] auto native_scan(std::filesystem::path path) -> std::generator<DirentResult>;
+    // dir / names[0] / names[1] ..., built as one string of the final size and
+    // moved into the path, instead of one temporary path per operator/
+    [[nodiscard]] auto join(const std::filesystem::path& dir, std::initializer_list<std::string_view> names)
+        -> std::filesystem::path;
+    // Rough number of entries in a directory, derived from its on-disk size where
+    // the platform exposes one. Only meant for pre-sizing containers.
+    [[nodiscard]] auto entry_count_hint(const std::filesystem::path& path) noexcept -> std::optional<std::size_t>;
+    // One stat (or lstat, without follow_symlinks) of path
+    [[nodiscard]] auto stamp(const std::filesystem::path& path, bool follow_symlinks = true) -> Result<file_stamp>;
+    // A stamp from a statx that asks only for type and inode, and for size and
+    // mtime when `detailed`, so filesystems that fetch attributes remotely
+    // (NFS, FUSE) go no further than needed. Fields not asked for are 0.
+    // stamp() on platforms without statx.
+    [[nodiscard]] auto probe(const std::filesystem::path& path, bool follow_symlinks, bool detailed)
+        -> Result<file_stamp>;
     [[nodiscard]] auto exists(const std::filesystem::path& path) noexcept -> bool;
     [[nodiscard]] auto rename(const std::filesystem::path& from, const std::filesystem::path& to) -> VoidResult;
+    // A rename that never replaces `to` (file_exists instead): renameat2 with
+    // RENAME_NOREPLACE where the kernel and filesystem take it, else a hard link
+    // to `to` followed by unlinking `from`, since link() refuses an existing
+    // name on every filesystem, NFS included. A filesystem that can do neither
+    // fails with its error; nothing here falls back to a replacing rename.
+    [[nodiscard]] auto rename_no_replace(const std::filesystem::path& from, const std::filesystem::path& to)
+        -> VoidResult;
+    // renameat2(RENAME_NOREPLACE) between two open directories, with names
+    // relative to them. Fails with file_exists instead of replacing the target,
+    // so no existence probe is needed first. Linux only; elsewhere not_supported.
+    [[nodiscard]] auto rename_at(
+        const directory_handle&      from_dir,
+        const std::filesystem::path& from_name,
+        const directory_handle&      to_dir,
+        const std::filesystem::path& to_name
+    ) -> VoidResult;
+    // Copies a regular file's data, mode and mtime to a new file `to` (never
+    // replacing one: file_exists). On Linux the bytes stay in the kernel: FICLONE
+    // where the filesystem can share extents, else copy_file_range or sendfile.
+    // On Linux the copy must match the source's size, the source must not have
+    // changed meanwhile (else resource_unavailable_try_again), and the data and
+    // the new name are synced before it returns, so the source can go.
+    // A partial copy is removed again on failure.
+    [[nodiscard]] auto copy_file(const std::filesystem::path& from, const std::filesystem::path& to) -> VoidResult;
+    // Reads a whole file front to back into buffer, handing every filled part of
+    // it to consume. Access is announced as sequential so readahead stays ahead.
+    [[nodiscard]] auto read_chunks(
+        const std::filesystem::path&                          path,
+        std::span<std::byte>                                  buffer,
+        const std::function<void(std::span<const std::byte>)>& consume
+    ) -> VoidResult;
+    // Whether two files hold the same bytes, read side by side one buffer's
+    // worth at a time and compared as they arrive; stops at the first mismatch.
+    [[nodiscard]] auto same_contents(
+        const std::filesystem::path& left,
+        const std::filesystem::path& right,
+        std::span<std::byte>         left_buffer,
+        std::span<std::byte>         right_buffer
+    ) -> Result<bool>;
+    // Replaces target with a hard link to original: the link is made under a
+    // temporary name next to target and renamed over it, so target never stops
+    // existing. Fails (cross_device_link) when the two are on different filesystems.
+    [[nodiscard]] auto link_over(const std::filesystem::path& original, const std::filesystem::path& target) -> VoidResult;
+    // Flushes a file just written through a stream to disk, e.g. before it is
+    // renamed over the file it replaces. fdatasync on Linux, a no-op elsewhere.
+    [[nodiscard]] auto sync_file(const std::filesystem::path& path) -> VoidResult;
+    [[nodiscard]] auto remove(const std::filesystem::path& path) -> VoidResult;
     [[nodiscard]] auto create_directories(const std::filesystem::path& path) -> VoidResult;
 }
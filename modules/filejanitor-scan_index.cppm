@@ -0,0 +1,68 @@
+// Module partition: scan_index
+// Exports: scan_index class
+// Depends on: scanner, safe_fs (transitively: result_types)
+module;
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+export module filejanitor:scan_index;
+
+// Re-export dependency partitions
+export import :scanner;
+export import :safe_fs;
+
+// Define and export the persisted scan index
+export namespace fs_ops::scanner {
+    // What the previous scan saw: every directory's mtime, its subdirectories
+    // and a stamp (device, inode, size, mtime) of each regular file in it.
+    //
+    // A directory whose mtime is unchanged had no entry created, removed or
+    // renamed in it, so rescan() skips listing it (its subdirectories are still
+    // visited). Files modified in place inside such a directory go unnoticed.
+    class scan_index {
+    public:
+        // no_such_file_or_directory when there is no index yet
+        [[nodiscard]] static auto load(const std::filesystem::path& file) -> Result<scan_index>;
+
+        // Written to a temporary file first, synced and renamed over `file`
+        [[nodiscard]] auto save(const std::filesystem::path& file) const -> VoidResult;
+
+        // Like collect_files(target_directory, options), but only yields regular
+        // files that are new or whose stamp changed since the last rescan, then
+        // records what it saw. Only recursive and max_depth are honored: every
+        // directory is listed with native_scan whatever options.backend says,
+        // and symlinked directories are never descended whatever
+        // options.symlinks says. A directory that changed costs one stat per
+        // file in it, since the stamp is what the next rescan compares.
+        // metadata_bin is always filled, from the stamps taken anyway.
+        [[nodiscard]] auto rescan(
+            const std::filesystem::path& target_directory,
+            const scan_options&          options
+        ) -> file_collection;
+
+        // Forgets one file so the next rescan yields it again (e.g. after its
+        // move failed)
+        auto forget(const std::filesystem::path& file) -> void;
+
+    private:
+        struct directory_record {
+            std::int64_t                                          mtime_ns{0};
+            std::vector<std::string>                              subdirs{};
+            std::unordered_map<std::string, safe_fs::file_stamp> files{};
+        };
+
+        // Lists dir afresh, replacing record's subdirectories and stamps, and
+        // appends its new or changed files to found
+        static auto relist(
+            const std::filesystem::path& dir,
+            directory_record&            record,
+            file_collection&             found
+        ) -> void;
+
+        std::unordered_map<std::string, directory_record> directories_{};
+    };
+}
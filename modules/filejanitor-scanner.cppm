@@ -1,20 +1,84 @@
 // Module partition: scanner
-// Exports: file_collection, collect_files()
+// Exports: symlink_policy, scan_backend, scan_shard, scan_options, file_collection,
+//          collect_files()
+// Depends on: fs_ops
 module;
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <memory_resource>
+#include <string_view>
 #include <system_error>
 #include <vector>
 
 export module filejanitor:scanner;
 
+// Re-export dependency partitions
+export import :fs_ops;
+
 // Define and export types directly in the module
 export namespace fs_ops::scanner {
+    // Only governs whether symlinked directories are descended into; symlinks
+    // to regular files are collected either way, as in the flat scan.
+    enum class symlink_policy : std::int8_t {
+        skip,
+        follow,
+    };
+
+    // standard lists through std::filesystem::directory_iterator; native uses
+    // safe_fs::native_scan (getdents64 on Linux) and skips stat for any entry
+    // whose d_type already says regular file or directory.
+    enum class scan_backend : std::int8_t {
+        standard,
+        native,
+    };
+
+    // Splits one root between runs that never talk to each other (processes,
+    // or hosts sharing the tree): each entry directly under the root, and with
+    // it everything below it, belongs to exactly one of count shards, picked by
+    // a hash of its name that comes out the same on every host. Shards moving
+    // into a shared bucket cannot overwrite each other because no executor route
+    // replaces: renames use RENAME_NOREPLACE, or a hard link plus unlink on
+    // filesystems that reject the flag (EINVAL, e.g. NFS), and cross-device
+    // copies create their target exclusively.
+    struct scan_shard {
+        std::uint32_t index{0};
+        std::uint32_t count{1};   // 1 = the whole root
+
+        [[nodiscard]] auto owns(std::string_view name) const noexcept -> bool;
+    };
+
+    struct scan_options {
+        bool           recursive{false};
+        int            max_depth{-1};      // levels below the root, -1 = unlimited
+        symlink_policy symlinks{symlink_policy::skip};
+        std::size_t    worker_count{0};     // 0 = hardware concurrency
+        scan_backend   backend{scan_backend::standard};
+        scan_shard     shard{};
+
+        // Fill file_collection::metadata_bin. Costs one statx (type, inode,
+        // size, mtime) per regular file whose d_type already said so; entries
+        // with an unknown d_type and symlinks are queried anyway, and answer it
+        // from that same call.
+        bool collect_metadata{false};
+
+        // Backs the scanner's own bookkeeping (listing frames, visited set),
+        // never the collected paths; null = the heap. Must outlive the call.
+        std::pmr::memory_resource* memory{nullptr};
+    };
+
     struct file_collection {
         std::vector<std::filesystem::path> file_bin;
         std::vector<std::error_code>       error_bin;
+        std::vector<file_metadata>         metadata_bin;   // empty, or one per file_bin entry
     };
 
     [[nodiscard]] auto collect_files(const std::filesystem::path& target_directory)
         -> file_collection;
+
+    [[nodiscard]] auto collect_files(
+        const std::filesystem::path& target_directory,
+        const scan_options&          options
+    ) -> file_collection;
 }
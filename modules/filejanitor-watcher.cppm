@@ -0,0 +1,45 @@
+// Module partition: watcher
+// Exports: watch_options, batch_callback, watch()
+// Depends on: result_types, executor, planner
+module;
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <stop_token>
+
+export module filejanitor:watcher;
+
+// Re-export dependency partitions
+export import :result_types;
+export import :executor;
+export import :planner;
+
+// Declare and export the watch mode
+export namespace fs_ops::watcher {
+    struct watch_options {
+        // A file is only moved once this long has passed without another write
+        // or close event for it, so files still being written stay put
+        std::chrono::milliseconds debounce{250};
+        std::size_t               max_batch{4096};
+        planner::planning_options planning{};
+    };
+
+    // Called on the watching thread after every executed micro-batch
+    using batch_callback = std::function<void(const executor::execution_report&)>;
+
+    // Organizes files as they arrive directly in root (closed after writing or
+    // moved in), in debounced micro-batches through the planner and executor.
+    // One execution context lives for the whole watch, so bucket directories
+    // and collision names are cached across batches. Files already present are
+    // queued once at startup; there are no periodic scans, and the thread
+    // sleeps in poll() while nothing happens. Returns once stop is requested.
+    // Linux (inotify) only; elsewhere not_supported.
+    [[nodiscard]] auto watch(
+        const std::filesystem::path& root,
+        const watch_options&         options,
+        std::stop_token              stop,
+        const batch_callback&        on_batch
+    ) -> VoidResult;
+}
@@ -6,13 +6,31 @@ export module filejanitor;
 export import :result_types;
 export import :fs_ops;
 export import :scanner;
+export import :concurrency;
+export import :extension;
+export import :rules;
+export import :instrumentation;
+export import :arena;
 
 // Dependency layer partitions
 export import :safe_fs;
 export import :movement_plan;
+export import :compact_plan;
+export import :plan_file;
 export import :operation_result;
 export import :execution_report;
+export import :report_file;
+export import :execution_context;
+export import :journal;
+export import :async;
+export import :scan_index;
 
 // Aggregation partitions
 export import :planner;
+export import :dedup;
 export import :executor;
+export import :pipeline;
+export import :multi_root;
+export import :watcher;
+export import :output;
+export import :cli;
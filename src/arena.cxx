@@ -0,0 +1,98 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace
+{
+  std::atomic<std::uint64_t> next_arena_id{1};
+
+  // The chunk this thread is carving up, and which arena it came from
+  struct thread_chunk
+  {
+    std::uint64_t arena{0};
+    void*         next{nullptr};
+    std::size_t   left{0};
+  };
+
+  thread_local auto current_chunk{thread_chunk{}};
+} // namespace
+
+namespace fs_ops::arena
+{
+  run_arena::run_arena(const std::size_t initial_block_size)
+      : id_{next_arena_id.fetch_add(1, std::memory_order_relaxed)},
+        blocks_{initial_block_size, std::pmr::new_delete_resource()}
+  {}
+
+  auto run_arena::bytes_allocated() const -> std::size_t
+  {
+    const auto lock{std::scoped_lock{mutex_}};
+    return allocated_;
+  }
+
+  auto run_arena::take(const std::size_t bytes, const std::size_t alignment)
+              -> void*
+  {
+    allocated_ += bytes;
+    return blocks_.allocate(bytes, alignment);
+  }
+
+  auto run_arena::do_allocate(const std::size_t bytes, const std::size_t alignment)
+              -> void*
+  {
+    auto& chunk{current_chunk};
+    if ( chunk.arena == id_ )
+    {
+      if ( auto* const block{std::align(alignment, bytes, chunk.next, chunk.left)} )
+      {
+        chunk.next = static_cast<std::byte*>(block) + bytes;
+        chunk.left -= bytes;
+        return block;
+      }
+    }
+
+    const auto lock{std::scoped_lock{mutex_}};
+
+    // Would waste most of a chunk; the tail of the current one stays usable
+    if ( bytes + alignment > thread_chunk_size / 4 )
+      return take(bytes, alignment);
+
+    const auto  chunk_alignment{std::max(alignment, alignof(std::max_align_t))};
+    auto* const block{take(thread_chunk_size, chunk_alignment)};
+    chunk = {
+         .arena{id_},
+         .next{static_cast<std::byte*>(block) + bytes},
+         .left{thread_chunk_size - bytes},
+    };
+    return block;
+  }
+
+  // Monotonic: a block is only given back when the whole arena is
+  auto run_arena::do_deallocate(
+              [[maybe_unused]] void* const       pointer,
+              [[maybe_unused]] const std::size_t bytes,
+              [[maybe_unused]] const std::size_t alignment
+  ) -> void
+  {}
+
+  auto run_arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+              -> bool
+  {
+    return this == &other;
+  }
+} // namespace fs_ops::arena
@@ -0,0 +1,354 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+using namespace std::string_view_literals;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+  using arg_iterator = std::span<char* const>::iterator;
+
+  auto invalid_argument() -> std::unexpected<std::error_code>
+  {
+    return std::unexpected{std::make_error_code(std::errc::invalid_argument)};
+  }
+
+  template <typename T>
+  auto parse_number(const std::string_view text) -> Result<T>
+  {
+    auto       value{T{}};
+    const auto last{text.data() + text.size()};
+    const auto [end, ec]{std::from_chars(text.data(), last, value)};
+
+    return ec == std::errc{} and end == last ? Result<T>{value}
+                                             : invalid_argument();
+  }
+
+  // Advances `it` onto the flag's value, failing if the flag is the last argument
+  auto take_value(arg_iterator& it, const arg_iterator end)
+              -> Result<std::string_view>
+  {
+    return std::next(it) != end ? Result<std::string_view>{*++it}
+                                : invalid_argument();
+  }
+
+  auto assign_path(arg_iterator& it, const arg_iterator end, fs::path& target)
+              -> VoidResult
+  {
+    return take_value(it, end).transform([&target](const std::string_view value) {
+      target = value;
+    });
+  }
+
+  auto append_path(
+              arg_iterator&          it,
+              const arg_iterator     end,
+              std::vector<fs::path>& target
+  ) -> VoidResult
+  {
+    return take_value(it, end).transform([&target](const std::string_view value) {
+      target.emplace_back(value);
+    });
+  }
+
+  // "K/N": shard K, counted from 0, of N
+  auto assign_shard(
+              arg_iterator&                it,
+              const arg_iterator           end,
+              fs_ops::scanner::scan_shard& target
+  ) -> VoidResult
+  {
+    return take_value(it, end).and_then([&target](const std::string_view value) {
+      const auto slash{value.find('/')};
+      if ( slash == std::string_view::npos )
+        return VoidResult{invalid_argument()};
+
+      const auto index{parse_number<std::uint32_t>(value.substr(0, slash))};
+      const auto count{parse_number<std::uint32_t>(value.substr(slash + 1))};
+      if ( not index or not count or *index >= *count )
+        return VoidResult{invalid_argument()};
+
+      target = {.index = *index, .count = *count};
+      return VoidResult{};
+    });
+  }
+
+  auto assign_mode(
+              arg_iterator&        it,
+              const arg_iterator   end,
+              output::output_mode& target
+  ) -> VoidResult
+  {
+    using enum output::output_mode;
+
+    return take_value(it, end).and_then([&target](const std::string_view value) {
+      if ( value == "quiet"sv )
+        target = quiet;
+      else if ( value == "summary"sv )
+        target = summary;
+      else if ( value == "sampled"sv )
+        target = sampled;
+      else if ( value == "full"sv )
+        target = full;
+      else
+        return VoidResult{invalid_argument()};
+
+      return VoidResult{};
+    });
+  }
+
+  auto assign_action(
+              arg_iterator&                    it,
+              const arg_iterator               end,
+              fs_ops::dedup::duplicate_action& target
+  ) -> VoidResult
+  {
+    using enum fs_ops::dedup::duplicate_action;
+
+    return take_value(it, end).and_then([&target](const std::string_view value) {
+      if ( value == "skip"sv )
+        target = skip;
+      else if ( value == "link"sv )
+        target = hard_link;
+      else
+        return VoidResult{invalid_argument()};
+
+      return VoidResult{};
+    });
+  }
+
+  template <typename T>
+  auto assign_number(arg_iterator& it, const arg_iterator end, T& target)
+              -> VoidResult
+  {
+    return take_value(it, end)
+                .and_then(parse_number<T>)
+                .transform([&target](const T value) { target = value; });
+  }
+} // namespace
+
+namespace cli
+{
+  auto parse_arguments(const std::span<char* const> args) -> Result<options>
+  {
+    auto opts{options{}};
+    auto debounce_ms{opts.watch.debounce.count()};
+
+    for ( auto it{args.begin()}; it != args.end(); ++it )
+    {
+      const auto arg{std::string_view{*it}};
+      auto       step{VoidResult{}};
+
+      if ( arg == "-r"sv or arg == "--recursive"sv )
+        opts.scan.recursive = true;
+      else if ( arg == "--follow-symlinks"sv )
+        opts.scan.symlinks = fs_ops::scanner::symlink_policy::follow;
+      else if ( arg == "--max-depth"sv )
+        step = assign_number(it, args.end(), opts.scan.max_depth);
+      else if ( arg == "--scan-threads"sv )
+        step = assign_number(it, args.end(), opts.scan.worker_count);
+      else if ( arg == "--manifest"sv )
+        step = assign_path(it, args.end(), opts.manifest_file);
+      else if ( arg == "--root-threads"sv )
+        step = assign_number(it, args.end(), opts.root_workers);
+      else if ( arg == "--shard"sv )
+        step = assign_shard(it, args.end(), opts.scan.shard);
+      else if ( arg == "--native-scan"sv )
+        opts.scan.backend = fs_ops::scanner::scan_backend::native;
+      else if ( arg == "--plan-threads"sv )
+        step = assign_number(it, args.end(), opts.planning.worker_count);
+      else if ( arg == "--rules"sv )
+        step = assign_path(it, args.end(), opts.rules_file);
+      else if ( arg == "--dedup"sv )
+      {
+        opts.deduplicating = true;
+        step               = assign_action(it, args.end(), opts.dedup.action);
+      }
+      else if ( arg == "--hash-threads"sv )
+        step = assign_number(it, args.end(), opts.dedup.worker_count);
+      else if ( arg == "--exec-threads"sv )
+        step = assign_number(it, args.end(), opts.execution.worker_count);
+      else if ( arg == "--io-uring"sv )
+      {
+        opts.execution.backend = fs_ops::executor::execution_backend::io_uring;
+        opts.loop.backend      = fs_ops::async::io_backend::io_uring;
+      }
+      else if ( arg == "--async"sv )
+        opts.async_execution = true;
+      else if ( arg == "--io-threads"sv )
+        step = assign_number(it, args.end(), opts.loop.io_threads);
+      else if ( arg == "--in-flight"sv )
+        step = assign_number(it, args.end(), opts.loop.max_in_flight);
+      else if ( arg == "--cross-device"sv )
+        opts.execution.cross_device = true;
+      else if ( arg == "--copy-threads"sv )
+        step = assign_number(it, args.end(), opts.execution.transfer_workers);
+      else if ( arg == "--pipeline"sv )
+        opts.pipelined = true;
+      else if ( arg == "--batch-size"sv )
+        step = assign_number(it, args.end(), opts.pipeline.batch_size);
+      else if ( arg == "--queue-depth"sv )
+        step = assign_number(it, args.end(), opts.pipeline.queue_depth);
+      else if ( arg == "--watch"sv )
+        opts.watching = true;
+      else if ( arg == "--debounce-ms"sv )
+        step = assign_number(it, args.end(), debounce_ms);
+      else if ( arg == "--index"sv )
+        step = assign_path(it, args.end(), opts.index_file);
+      else if ( arg == "--dry-run"sv )
+        opts.dry_run = true;
+      else if ( arg == "--output"sv )
+        step = assign_mode(it, args.end(), opts.output);
+      else if ( arg == "--ndjson"sv )
+        step = assign_path(it, args.end(), opts.ndjson_file);
+      else if ( arg == "--report-out"sv )
+        step = assign_path(it, args.end(), opts.report_file);
+      else if ( arg == "--merge-report"sv )
+        step = append_path(it, args.end(), opts.merge_reports);
+      else if ( arg == "--stats"sv )
+        step = assign_path(it, args.end(), opts.stats_file);
+      else if ( arg == "--write-plan"sv )
+        step = assign_path(it, args.end(), opts.write_plan);
+      else if ( arg == "--execute-plan"sv )
+        step = assign_path(it, args.end(), opts.execute_plan);
+      else if ( arg == "--journal"sv )
+        step = assign_path(it, args.end(), opts.journal_file);
+      else if ( arg == "--resume"sv )
+      {
+        opts.resuming = true;
+        step          = assign_path(it, args.end(), opts.journal_file);
+      }
+      else if ( arg == "--undo"sv )
+      {
+        opts.undoing = true;
+        step         = assign_path(it, args.end(), opts.journal_file);
+      }
+      else if ( not arg.starts_with('-') )
+        opts.roots.emplace_back(arg);
+      else
+        step = invalid_argument();
+
+      if ( not step )
+        return std::unexpected{step.error()};
+    }
+
+    // One root runs as it always has; several (or a manifest) run as jobs
+    if ( opts.roots.size() == 1 )
+    {
+      opts.root = opts.roots.front();
+      opts.roots.clear();
+    }
+
+    // A watch moves files as they arrive; there is no plan to dry-run or dedup
+    if ( opts.watching and (opts.dry_run or opts.deduplicating) )
+      return invalid_argument();
+
+    // Links are made right before executing, which --write-plan never does
+    using enum fs_ops::dedup::duplicate_action;
+
+    const auto linking{opts.deduplicating and opts.dedup.action == hard_link};
+    if ( linking and not opts.write_plan.empty() )
+      return invalid_argument();
+
+    // A journal indexes one plan that really executes; resume and undo take
+    // that plan from the journal itself
+    const auto journaling{not opts.journal_file.empty()};
+    const auto streaming{opts.watching or opts.pipelined};
+    if ( journaling
+         and (streaming or opts.dry_run or not opts.write_plan.empty()) )
+      return invalid_argument();
+
+    // Watch and pipeline runs drive their own executors
+    if ( opts.async_execution and streaming )
+      return invalid_argument();
+
+    const auto from_journal{opts.resuming or opts.undoing};
+    if ( (opts.resuming and opts.undoing)
+         or (from_journal and not opts.execute_plan.empty()) )
+      return invalid_argument();
+
+    // Several roots just scan, plan and execute; whatever is tied to a single
+    // plan or a single root's index stays a single-root feature
+    const auto multi_root{not opts.roots.empty() or not opts.manifest_file.empty()};
+    const auto one_plan{journaling or from_journal or not opts.execute_plan.empty()
+                        or opts.dry_run or not opts.write_plan.empty()
+                        or opts.deduplicating or not opts.index_file.empty()};
+    if ( multi_root and (streaming or one_plan or opts.async_execution) )
+      return invalid_argument();
+
+    // An index records the whole tree, while a shard scans only its own part;
+    // the streaming scans do not shard at all
+    if ( opts.scan.shard.count > 1 and (streaming or not opts.index_file.empty()) )
+      return invalid_argument();
+
+    // Merging reads reports and runs nothing; a watch has no one report to save
+    const auto merging{not opts.merge_reports.empty()};
+    if ( (merging and (multi_root or from_journal or not opts.execute_plan.empty()))
+         or (opts.watching and not opts.report_file.empty()) )
+      return invalid_argument();
+
+    opts.watch.debounce = std::chrono::milliseconds{debounce_ms};
+    return opts;
+  }
+
+  auto usage() noexcept -> std::string_view
+  {
+    return "Usage: Main [directory...] [options]\n"
+           "  -r, --recursive        descend into subdirectories\n"
+           "      --max-depth N      levels below the root (-1 = unlimited)\n"
+           "      --follow-symlinks  descend into symlinked directories\n"
+           "      --manifest F       also organize every root listed in file F\n"
+           "      --root-threads N   roots organized at once (0 = hardware)\n"
+           "      --shard K/N        organize shard K (from 0) of N of the root\n"
+           "      --scan-threads N   recursive scan workers (0 = hardware)\n"
+           "      --native-scan      list directories with getdents64 (Linux)\n"
+           "      --plan-threads N   parallel planner workers (0 = hardware)\n"
+           "      --rules F          bucket files by the rules in file F\n"
+           "      --dedup A          skip or link byte-identical duplicates\n"
+           "      --hash-threads N   dedup stat and hash workers (0 = hardware)\n"
+           "      --exec-threads N   parallel executor workers (0 = hardware)\n"
+           "      --io-uring         batch renames through io_uring (Linux)\n"
+           "      --async            run moves as coroutines on one event loop\n"
+           "      --io-threads N     threads doing an async run's blocking I/O\n"
+           "      --in-flight N      moves an async run keeps in flight at once\n"
+           "      --cross-device     copy+unlink when a bucket is on another fs\n"
+           "      --copy-threads N   workers copying large cross-device files\n"
+           "      --pipeline         stream scan -> plan -> execute in batches\n"
+           "      --batch-size N     files per pipeline batch\n"
+           "      --queue-depth N    batches buffered between pipeline stages\n"
+           "      --watch            keep organizing files as they arrive (Linux)\n"
+           "      --debounce-ms N    quiet time before a watched file is moved\n"
+           "      --index F          rescan incrementally against index file F\n"
+           "      --write-plan F     save the plan to file F instead of executing\n"
+           "      --execute-plan F   run saved plan F, skipping scan and plan\n"
+           "      --journal F        record completed moves in journal F\n"
+           "      --resume F         finish the plan journal F was recording\n"
+           "      --undo F           move everything journal F records back\n"
+           "      --dry-run          show final names without moving anything\n"
+           "      --output M         quiet, summary, sampled or full (default)\n"
+           "      --ndjson F         log plan and results to F as NDJSON\n"
+           "      --report-out F     save the execution report to file F\n"
+           "      --merge-report F   merge saved report F into one (repeatable)\n"
+           "      --stats F          write timings and counters as JSON to F\n"sv;
+  }
+} // namespace cli
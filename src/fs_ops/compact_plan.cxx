@@ -0,0 +1,206 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs  = std::filesystem;
+namespace rng = std::ranges;
+
+namespace
+{
+  // Ids are dense indices into a table that is only ever appended to
+  template <typename Table>
+  auto next_id(const Table& table) -> std::uint32_t
+  {
+    return static_cast<std::uint32_t>(table.size());
+  }
+
+  struct split_path
+  {
+    std::string parent;
+    std::string name;
+  };
+
+#if defined(_WIN32)
+  // Native Windows paths are wide, so both parts are narrowed (allocating)
+  auto split(const fs::path& path) -> split_path
+  {
+    return {.parent{path.parent_path().string()}, .name{path.filename().string()}};
+  }
+#else
+  struct split_view
+  {
+    std::string_view parent;
+    std::string_view name;
+  };
+
+  // parent_path() and filename() as views into the path's own string
+  auto split(const fs::path& path) -> split_view
+  {
+    const auto text{std::string_view{path.native()}};
+    const auto slash{text.find_last_of('/')};
+    if ( slash == std::string_view::npos )
+      return {.parent{}, .name{text}};
+
+    // "a//b" has parent "a"; "/b" keeps its root "/"
+    const auto last{text.find_last_not_of('/', slash)};
+    const auto parent_size{last == std::string_view::npos ? 1 : last + 1};
+    return {.parent{text.substr(0, parent_size)}, .name{text.substr(slash + 1)}};
+  }
+#endif
+} // namespace
+
+namespace fs_ops
+{
+  compact_plan::compact_plan(fs::path root_path)
+      : root_{std::move(root_path)}
+  {}
+
+  auto compact_plan::reserve(const std::size_t operation_count) -> void
+  {
+    ops_.reserve(operation_count);
+  }
+
+  auto compact_plan::intern_bucket(const std::string_view name) -> std::uint32_t
+  {
+    if ( const auto found{bucket_ids_.find(name)}; found != bucket_ids_.end() )
+      return found->second;
+
+    const auto id{next_id(bucket_names_)};
+    bucket_ids_.emplace(name, id);
+    bucket_names_.emplace_back(name);
+    return id;
+  }
+
+  auto compact_plan::intern_source_dir(const std::string_view dir) -> std::uint32_t
+  {
+    const auto found{source_dir_ids_.find(dir)};
+    if ( found != source_dir_ids_.end() )
+      return found->second;
+
+    const auto id{next_id(source_dirs_)};
+    source_dir_ids_.emplace(dir, id);
+    source_dirs_.emplace_back(dir);
+    return id;
+  }
+
+  auto compact_plan::add(
+              const fs::path&      source,
+              const std::uint32_t  bucket,
+              const file_metadata& metadata
+  ) -> void
+  {
+    const auto [parent, name]{split(source)};
+
+    ops_.push_back({
+         .name_offset{names_.size()},
+         .name_length{static_cast<std::uint32_t>(name.size())},
+         .source_dir{intern_source_dir(parent)},
+         .bucket{bucket}
+    });
+
+    names_.append(name);
+
+    if ( metadata.known )
+    {
+      metadata_.resize(ops_.size() - 1);
+      metadata_.push_back(metadata);
+    }
+  }
+
+  auto compact_plan::size() const noexcept -> std::size_t { return ops_.size(); }
+
+  auto compact_plan::empty() const noexcept -> bool { return ops_.empty(); }
+
+  auto compact_plan::root() const noexcept -> const fs::path& { return root_; }
+
+  auto compact_plan::bucket_count() const noexcept -> std::size_t
+  {
+    return bucket_names_.size();
+  }
+
+  auto compact_plan::bucket_name(const std::uint32_t bucket) const
+              -> const std::string&
+  {
+    return bucket_names_[bucket];
+  }
+
+  auto compact_plan::source_dir_count() const noexcept -> std::size_t
+  {
+    return source_dirs_.size();
+  }
+
+  auto compact_plan::source_dir(const std::uint32_t dir) const -> const fs::path&
+  {
+    return source_dirs_[dir];
+  }
+
+  auto compact_plan::record(const std::size_t index) const
+              -> const compact_operation&
+  {
+    return ops_[index];
+  }
+
+  auto compact_plan::name_arena() const noexcept -> std::string_view
+  {
+    return names_;
+  }
+
+  auto compact_plan::bucket_of(const std::size_t index) const -> std::uint32_t
+  {
+    return ops_[index].bucket;
+  }
+
+  auto compact_plan::metadata(const std::size_t index) const -> file_metadata
+  {
+    return index < metadata_.size() ? metadata_[index] : file_metadata{};
+  }
+
+  auto compact_plan::filename(const std::size_t index) const -> std::string_view
+  {
+    const auto& op{ops_[index]};
+    return std::string_view{names_}.substr(op.name_offset, op.name_length);
+  }
+
+  auto compact_plan::source(const std::size_t index) const -> fs::path
+  {
+    return safe_fs::join(source_dirs_[ops_[index].source_dir], {filename(index)});
+  }
+
+  auto compact_plan::destination(const std::size_t index) const -> fs::path
+  {
+    const auto& bucket{bucket_names_[ops_[index].bucket]};
+    return safe_fs::join(root_, {bucket, filename(index)});
+  }
+
+  auto compact_plan::operation(const std::size_t index) const -> successful_operation
+  {
+    return {
+         .source{source(index)},
+         .destination{destination(index)},
+         .bucket_name{bucket_names_[ops_[index].bucket]},
+         .metadata{metadata(index)}
+    };
+  }
+
+  auto compact_plan::to_movement_plan() const -> movement_plan
+  {
+    return {operations() | rng::to<std::vector>()};
+  }
+} // namespace fs_ops
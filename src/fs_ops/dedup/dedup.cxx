@@ -0,0 +1,379 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <xxhash.h>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs  = std::filesystem;
+namespace rng = std::ranges;
+namespace vws = std::views;
+
+using namespace fs_ops;
+using namespace fs_ops::dedup;
+
+namespace
+{
+  // Large enough that the per-call cost vanishes next to the transfer itself,
+  // so hashing runs at whatever rate the disk delivers
+  constexpr std::size_t read_buffer_size{1024UZ * 1024UZ};
+
+  using stamp_table = std::vector<std::optional<safe_fs::file_stamp>>;
+
+  struct content_hash
+  {
+    std::uint64_t low{0};
+    std::uint64_t high{0};
+
+    auto operator==(const content_hash&) const -> bool = default;
+  };
+
+  // XXH3 output is already uniformly distributed; half of it is a fine bucket key
+  struct content_hash_key
+  {
+    auto operator()(const content_hash& hash) const noexcept -> std::size_t
+    {
+      return static_cast<std::size_t>(hash.low);
+    }
+  };
+
+  // Plan index of the first file seen with each hash
+  using first_by_hash =
+              std::unordered_map<content_hash, std::size_t, content_hash_key>;
+
+  // One thread's read buffer and XXH3 state, reused for every file it hashes
+  class file_hasher
+  {
+  public:
+    file_hasher()
+        : buffer_(read_buffer_size),
+          state_{XXH3_createState()}
+    {}
+
+    auto hash(const fs::path& file) -> std::optional<content_hash>
+    {
+      if ( not state_ or XXH3_128bits_reset(state_.get()) == XXH_ERROR )
+        return std::nullopt;
+
+      auto* const state{state_.get()};
+      const auto  read{safe_fs::read_chunks(
+                  file,
+                  buffer_,
+                  [state](const std::span<const std::byte> chunk) {
+                    [[maybe_unused]] const auto updated{
+                         XXH3_128bits_update(state, chunk.data(), chunk.size())
+                    };
+                  }
+      )};
+      if ( not read )
+        return std::nullopt;
+
+      const auto digest{XXH3_128bits_digest(state)};
+      return content_hash{.low{digest.low64}, .high{digest.high64}};
+    }
+
+  private:
+    struct state_deleter
+    {
+      auto operator()(XXH3_state_t* const state) const noexcept -> void
+      {
+        XXH3_freeState(state);
+      }
+    };
+
+    std::vector<std::byte>                       buffer_;
+    std::unique_ptr<XXH3_state_t, state_deleter> state_;
+  };
+
+  auto resolve_worker_count(const std::size_t requested) -> std::size_t
+  {
+    const auto hardware{std::size_t{std::thread::hardware_concurrency()}};
+    return requested != 0 ? requested : std::max<std::size_t>(1, hardware);
+  }
+
+  // Hands [0, count) out to up to `workers` threads off a shared counter. Each
+  // thread gets its own callable from make_worker, so scratch state (a read
+  // buffer, a hash state) belongs to one thread and is never shared.
+  template <typename MakeWorker>
+  auto parallel_for(
+              const std::size_t count,
+              const std::size_t workers,
+              const MakeWorker& make_worker
+  ) -> void
+  {
+    auto       next{std::atomic<std::size_t>{0}};
+    const auto run{[&next, count, &make_worker] {
+      auto work{make_worker()};
+      for ( auto idx{next.fetch_add(1)}; idx < count; idx = next.fetch_add(1) )
+        work(idx);
+    }};
+
+    if ( workers <= 1 or count <= 1 )
+    {
+      run();
+      return;
+    }
+
+    const auto threads{std::min(workers, count)};
+    auto       pool{std::vector<std::jthread>{}};
+    pool.reserve(threads);
+
+    for ( auto thread{std::size_t{0}}; thread < threads; ++thread )
+      pool.emplace_back(run);
+  }
+
+  // One lstat per source the scan brought no metadata for: symlinks,
+  // directories and unreadable entries drop out
+  auto stamp_sources(const compact_plan& plan, const std::size_t workers)
+              -> stamp_table
+  {
+    auto stamps{stamp_table(plan.size())};
+
+    parallel_for(plan.size(), workers, [&plan, &stamps] {
+      return [&plan, &stamps](const std::size_t idx) {
+        if ( const auto scanned{plan.metadata(idx)}; scanned.known )
+        {
+          if ( not scanned.symlink )
+            stamps[idx] = safe_fs::file_stamp{
+                 .type{safe_fs::entry_type::regular},
+                 .device{scanned.device},
+                 .inode{scanned.inode},
+                 .size{scanned.size},
+                 .mtime_ns{scanned.mtime_ns},
+            };
+          return;
+        }
+
+        const auto found{safe_fs::stamp(plan.source(idx), false)};
+        if ( found and found->type == safe_fs::entry_type::regular )
+          stamps[idx] = *found;
+      };
+    });
+
+    return stamps;
+  }
+
+  // Files worth hashing, ordered by (size, plan index): only sizes shared by
+  // at least two distinct files survive, and each (device, inode) keeps only
+  // its first name, since further names of it are a single file already
+  auto hash_candidates(const stamp_table& stamps, const std::uint64_t min_size)
+              -> std::vector<std::size_t>
+  {
+    auto by_size{std::vector<std::size_t>{}};
+    for ( auto idx{std::size_t{0}}; idx < stamps.size(); ++idx )
+    {
+      if ( stamps[idx] and stamps[idx]->size >= min_size )
+        by_size.push_back(idx);
+    }
+
+    rng::sort(by_size, {}, [&stamps](const std::size_t idx) {
+      return std::pair{stamps[idx]->size, idx};
+    });
+
+    auto same_size{[&stamps](const std::size_t a, const std::size_t b) {
+      return stamps[a]->size == stamps[b]->size;
+    }};
+
+    auto candidates{std::vector<std::size_t>{}};
+    auto distinct{std::vector<std::size_t>{}};
+    auto inodes{std::set<std::pair<std::uint64_t, std::uint64_t>>{}};
+
+    for ( auto&& group : by_size | vws::chunk_by(same_size) )
+    {
+      distinct.clear();
+      inodes.clear();
+
+      // inode 0: the platform has none, so names cannot be told apart
+      for ( const auto idx : group )
+      {
+        const auto& stamp{*stamps[idx]};
+        if ( stamp.inode == 0 or inodes.emplace(stamp.device, stamp.inode).second )
+          distinct.push_back(idx);
+      }
+
+      if ( distinct.size() > 1 )
+        candidates.insert(candidates.end(), distinct.begin(), distinct.end());
+    }
+
+    return candidates;
+  }
+
+  auto unchanged(const fs::path& file, const safe_fs::file_stamp& expected) -> bool
+  {
+    const auto now{safe_fs::stamp(file, false)};
+    return now and *now == expected;
+  }
+
+  // Replacing a file is only safe on proof, and equal hashes are not one: the
+  // pair must still be as hashed, and its bytes must compare equal
+  class link_check
+  {
+  public:
+    link_check()
+        : left_(read_buffer_size),
+          right_(read_buffer_size)
+    {}
+
+    auto confirm(
+                const fs::path&  source,
+                const fs::path&  original,
+                const duplicate& dup
+    ) -> VoidResult
+    {
+      if ( not unchanged(source, dup.stamp)
+           or not unchanged(original, dup.original_stamp) )
+        return cancelled();
+
+      const auto same{safe_fs::same_contents(source, original, left_, right_)};
+      if ( not same )
+        return std::unexpected{same.error()};
+
+      return *same ? VoidResult{} : cancelled();
+    }
+
+  private:
+    static auto cancelled() -> std::unexpected<std::error_code>
+    {
+      return std::unexpected{std::make_error_code(std::errc::operation_canceled)};
+    }
+
+    std::vector<std::byte> left_;
+    std::vector<std::byte> right_;
+  };
+} // namespace
+
+namespace fs_ops::dedup
+{
+  auto find_duplicates(const compact_plan& plan, const dedup_options& options)
+              -> duplicate_set
+  {
+    const auto workers{resolve_worker_count(options.worker_count)};
+    const auto stamps{stamp_sources(plan, workers)};
+    const auto candidates{hash_candidates(stamps, options.min_size)};
+
+    auto hashes{std::vector<std::optional<content_hash>>(candidates.size())};
+    parallel_for(candidates.size(), workers, [&plan, &candidates, &hashes] {
+      return [&, hasher{file_hasher{}}](const std::size_t slot) mutable {
+        hashes[slot] = hasher.hash(plan.source(candidates[slot]));
+      };
+    });
+
+    // Candidates come grouped by size and in plan order within a size, so the
+    // first file seen with a hash is the one the others duplicate
+    auto found{duplicate_set{}};
+    auto first_with{first_by_hash{}};
+
+    for ( auto slot{std::size_t{0}}; slot < candidates.size(); ++slot )
+    {
+      const auto  idx{candidates[slot]};
+      const auto& stamp{*stamps[idx]};
+
+      if ( slot == 0 or stamps[candidates[slot - 1]]->size != stamp.size )
+        first_with.clear();
+
+      if ( not hashes[slot] )
+        continue;
+
+      ++found.files_hashed;
+      found.bytes_hashed += stamp.size;
+
+      const auto [original, inserted]{first_with.try_emplace(*hashes[slot], idx)};
+      if ( inserted )
+        continue;
+
+      found.duplicates.push_back({
+           .index{idx},
+           .original{original->second},
+           .stamp{stamp},
+           .original_stamp{*stamps[original->second]},
+      });
+      found.duplicate_bytes += stamp.size;
+    }
+
+    rng::sort(found.duplicates, {}, &duplicate::index);
+    return found;
+  }
+
+  auto without_duplicates(const compact_plan& plan, const duplicate_set& found)
+              -> compact_plan
+  {
+    auto result{compact_plan{plan.root()}};
+    result.reserve(plan.size() - found.duplicates.size());
+
+    // Interned in the same order, so bucket ids carry over unchanged
+    for ( auto bucket{std::uint32_t{0}}; bucket < plan.bucket_count(); ++bucket )
+    {
+      [[maybe_unused]] const auto id{result.intern_bucket(plan.bucket_name(bucket))};
+    }
+
+    auto next{found.duplicates.begin()};
+    for ( auto idx{std::size_t{0}}; idx < plan.size(); ++idx )
+    {
+      if ( next != found.duplicates.end() and next->index == idx )
+      {
+        ++next;
+        continue;
+      }
+
+      result.add(plan.source(idx), plan.bucket_of(idx), plan.metadata(idx));
+    }
+
+    return result;
+  }
+
+  auto link_duplicates(const compact_plan& plan, const duplicate_set& found)
+              -> executor::execution_report
+  {
+    auto report{executor::execution_report::start()};
+    auto check{link_check{}};
+
+    for ( const auto& dup : found.duplicates )
+    {
+      auto       source{plan.source(dup.index)};
+      auto       original{plan.source(dup.original)};
+      const auto linked{check.confirm(source, original, dup).and_then([&] {
+        return safe_fs::link_over(original, source);
+      })};
+
+      report = std::move(report).with_processed().finalize();
+      if ( linked )
+      {
+        report = std::move(report).with_success().finalize();
+        continue;
+      }
+
+      report = std::move(report)
+                           .with_failure(failed_operation{
+                                .source{std::move(source)},
+                                .destination{std::move(original)},
+                                .error{linked.error()},
+                           })
+                           .finalize();
+    }
+
+    return report;
+  }
+} // namespace fs_ops::dedup
@@ -0,0 +1,227 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF (before fmt to avoid conflicts)
+#include <algorithm>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fmt/format.h>
+
+module filejanitor;
+
+// NO import std; - conflicts with #include in GMF
+
+namespace fs  = std::filesystem;
+namespace vws = std::views;
+namespace rng = std::ranges;
+
+using namespace fs_ops;
+using namespace fs_ops::executor;
+
+namespace
+{
+  auto build_candidate(const fs::path& target) -> candidate
+  {
+    return {
+         .parent{target.parent_path()},
+         .stem{target.stem().string()},
+         .extension{target.extension().string()}
+    };
+  }
+
+  auto make_candidate_name(const candidate& c, const int idx) -> std::string
+  {
+    return fmt::format("{} ({}){}", c.stem, idx, c.extension);
+  }
+} // namespace
+
+namespace fs_ops::executor
+{
+  auto candidate_name(const fs::path& target, const int index) -> fs::path
+  {
+    const auto c{build_candidate(target)};
+    return c.parent / make_candidate_name(c, index);
+  }
+
+  directory_names::directory_names(
+              fs::path                         dir,
+              std::pmr::memory_resource* const memory
+  )
+      : dir_{std::move(dir)},
+        names_{arena::resource_or_heap(memory)},
+        next_index_{arena::resource_or_heap(memory)}
+  {}
+
+  auto directory_names::load(
+              const fs::path&                  dir,
+              std::pmr::memory_resource* const memory
+  ) -> directory_names
+  {
+    auto names{directory_names{dir, memory}};
+
+    for ( auto&& entry : safe_fs::native_scan(dir) )
+    {
+      // A directory that does not exist (yet) is completely listed: it is empty
+      if ( not entry )
+      {
+        names.complete_ = entry.error() == std::errc::no_such_file_or_directory;
+        break;
+      }
+      names.names_.emplace(entry->name);
+    }
+
+    return names;
+  }
+
+  auto directory_names::is_free(const std::string_view name) const -> bool
+  {
+    instrumentation::count(instrumentation::counter::collision_probes);
+    return not names_.contains(name)
+           and (complete_ or not safe_fs::exists(dir_ / name));
+  }
+
+  auto directory_names::insert(const std::string_view name) -> void
+  {
+    names_.emplace(name);
+  }
+
+  auto directory_names::claim_candidate(const fs::path& target)
+              -> std::optional<fs::path>
+  {
+    const auto c{build_candidate(target)};
+    const auto target_name{target.filename().string()};
+
+    auto slot{next_index_.find(target_name)};
+    if ( slot == next_index_.end() )
+      slot = next_index_.emplace(target_name, 0).first;
+
+    auto& next_index{slot->second};
+
+    const auto first{std::clamp(next_index, 1, max_candidate_index)};
+    const auto indices{vws::iota(first, max_candidate_index)};
+    const auto found{rng::find_if(indices, [this, &c](const int idx) {
+      return is_free(make_candidate_name(c, idx));
+    })};
+
+    if ( found == indices.end() )
+      return std::nullopt;
+
+    next_index = *found + 1;
+
+    auto name{make_candidate_name(c, *found)};
+    names_.emplace(name);
+    return c.parent / std::move(name);
+  }
+
+  execution_context::execution_context(std::pmr::memory_resource* const memory)
+      : memory_{arena::resource_or_heap(memory)},
+        ready_buckets_{memory_},
+        directories_{memory_}
+  {}
+
+  auto execution_context::ensure_bucket(const successful_operation& op) -> VoidResult
+  {
+    if ( ready_buckets_.contains(op.bucket_name) )
+      return {};
+
+    return safe_fs::create_directories(op.destination.parent_path())
+                .transform([this, &op] { ready_buckets_.emplace(op.bucket_name); });
+  }
+
+  auto execution_context::resolve_collision(const fs::path& target) -> fs::path
+  {
+    const auto parent{target.parent_path()};
+    const auto name{target.filename().string()};
+    auto       cached{directories_.find(parent.string())};
+
+    if ( cached == directories_.end() )
+    {
+      if ( not safe_fs::exists(target) )
+        return target;
+
+      auto names{directory_names::load(parent, memory_)};
+      cached = directories_.emplace(parent.string(), std::move(names)).first;
+    }
+    else if ( cached->second.is_free(name) )
+    {
+      cached->second.insert(name);
+      return target;
+    }
+
+    return cached->second.claim_candidate(target).value_or(target);
+  }
+
+  auto execution_context::names_for(const fs::path& dir) -> directory_names&
+  {
+    const auto key{dir.string()};
+    if ( auto cached{directories_.find(key)}; cached != directories_.end() )
+      return cached->second;
+
+    auto names{directory_names::load(dir, memory_)};
+    return directories_.emplace(key, std::move(names)).first->second;
+  }
+
+  auto execution_context::handle_for(const fs::path& dir) -> Result<directory_ref>
+  {
+    auto key{dir.string()};
+    if ( const auto cached{handles_.find(key)}; cached != handles_.end() )
+    {
+      handle_order_.splice(handle_order_.begin(), handle_order_, cached->second);
+      return cached->second->second;
+    }
+
+    auto opened{safe_fs::directory_handle::open(dir)};
+    if ( not opened and opened.error() == std::errc::too_many_files_open )
+    {
+      // Handles still held elsewhere stay open whatever the cache does
+      handles_.clear();
+      handle_order_.clear();
+      opened = safe_fs::directory_handle::open(dir);
+    }
+
+    return std::move(opened).transform(
+                [this, &key](safe_fs::directory_handle&& handle) {
+                  return cache_handle(
+                              std::move(key),
+                              std::make_shared<const safe_fs::directory_handle>(
+                                          std::move(handle)
+                              )
+                  );
+                }
+    );
+  }
+
+  auto execution_context::cache_handle(std::string key, directory_ref handle)
+              -> directory_ref
+  {
+    if ( handle_order_.size() >= max_open_handles )
+    {
+      handles_.erase(handle_order_.back().first);
+      handle_order_.pop_back();
+    }
+
+    handle_order_.emplace_front(key, handle);
+    handles_.emplace(std::move(key), handle_order_.begin());
+    return handle;
+  }
+
+  auto execution_context::record_arrival(const fs::path& target) -> void
+  {
+    if ( auto cached{directories_.find(target.parent_path().string())};
+         cached != directories_.end() )
+      cached->second.insert(target.filename().string());
+  }
+} // namespace fs_ops::executor
@@ -4,18 +4,27 @@
 
 module;
 
-// Standard headers in GMF (before fmt to avoid conflicts)
+// Standard headers in GMF
 #include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
 #include <expected>
 #include <filesystem>
 #include <functional>
-#include <optional>
+#include <limits>
+#include <memory_resource>
 #include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include <fmt/format.h>
-
 module filejanitor;
 
 // NO import std; - conflicts with #include in GMF
@@ -29,89 +38,201 @@ using namespace fs_ops::executor;
 
 namespace
 {
-  auto does_target_exist(const fs::path& target) -> std::optional<fs::path>
+  // Path-based move: probe the target, then rename to it or to a free sibling.
+  // The rename still refuses to replace, so a name taken in between only costs
+  // another probe. Every move returns where the file landed.
+  auto move_by_path(execution_context& context, const successful_operation& op)
+              -> Result<fs::path>
   {
-    return not safe_fs::exists(target) ? std::optional{target} : std::nullopt;
-  }
+    auto target{context.resolve_collision(op.destination)};
+    auto moved{safe_fs::rename_no_replace(op.source, target)};
 
-  auto build_candidate(const fs::path& target) -> candidate
-  {
-    return {
-         .parent{target.parent_path()},
-         .stem{target.stem().string()},
-         .extension{target.extension().string()}
-    };
+    for ( auto attempt{1};
+          not moved and moved.error() == std::errc::file_exists
+          and attempt < max_candidate_index;
+          ++attempt )
+    {
+      target = context.resolve_collision(op.destination);
+      moved  = safe_fs::rename_no_replace(op.source, target);
+    }
+
+    return moved.transform([&target] { return std::move(target); });
   }
 
-  auto make_candidate_path(const candidate& c, int idx) -> fs::path
+  // Move relative to the cached source and bucket directory handles. The rename
+  // itself refuses to replace an existing name, so the uncontended case costs
+  // one syscall and only EEXIST walks the "(N)" candidates.
+  auto move_no_replace(execution_context& context, const successful_operation& op)
+              -> Result<fs::path>
   {
-    return [idx, par{c.parent}, ext{c.extension}, stem{c.stem}] {
-      return fs::path{par / fmt::format("{} ({}){}", stem, idx, ext)};
-    }();
+    const auto source_dir{context.handle_for(op.source.parent_path())};
+    if ( not source_dir )
+      return std::unexpected{source_dir.error()};
+
+    const auto bucket_dir{context.handle_for(op.destination.parent_path())};
+    if ( not bucket_dir )
+      return std::unexpected{bucket_dir.error()};
+
+    const auto source_name{op.source.filename()};
+    auto       target{op.destination};
+    auto       moved{safe_fs::rename_at(
+                **source_dir,
+                source_name,
+                **bucket_dir,
+                target.filename()
+    )};
+
+    while ( not moved and moved.error() == std::errc::file_exists )
+    {
+      auto candidate{context.names_for(target.parent_path())
+                                 .claim_candidate(op.destination)};
+      if ( not candidate )
+        return std::unexpected{moved.error()};
+
+      target = std::move(*candidate);
+      moved  = safe_fs::rename_at(
+                  **source_dir,
+                  source_name,
+                  **bucket_dir,
+                  target.filename()
+      );
+    }
+
+    if ( not moved )
+      return std::unexpected{moved.error()};
+
+    context.record_arrival(target);
+    return target;
   }
 
-  auto make_candidate_paths(const candidate& c) -> std::vector<fs::path>
+  // Errors that say the fd-based route is unavailable rather than that the move
+  // failed: no *at() support on this platform, no RENAME_NOREPLACE on this
+  // filesystem (EINVAL), or too many directories to keep open at once. The path
+  // route does not replace either.
+  auto needs_path_fallback(const Result<fs::path>& moved) -> bool
   {
-    constexpr int max_candidate_index{100};
-    return vws::iota(1, max_candidate_index)
-           | vws::transform([&c](const int idx) {
-               return make_candidate_path(c, idx);
-             })
-           | rng::to<std::vector<fs::path>>();
+    if ( moved )
+      return false;
+
+    const auto& ec{moved.error()};
+    return ec == std::errc::not_supported or ec == std::errc::function_not_supported
+           or ec == std::errc::invalid_argument
+           or ec == std::errc::too_many_files_open;
   }
 
-  auto find_valid_candidate(const std::vector<fs::path>& c_paths)
-              -> std::optional<fs::path>
+  auto perform_move(execution_context& context, const successful_operation& op)
+              -> Result<fs::path>
   {
-    auto predicate_to_satisfy{[](const fs::path& c) {
-      return not safe_fs::exists(c);
-    }};
+    return context.ensure_bucket(op).and_then([&context, &op] {
+      auto moved{move_no_replace(context, op)};
+      if ( needs_path_fallback(moved) )
+        return move_by_path(context, op);
 
-    return [end{c_paths.end()},
-            result_it{rng::find_if(c_paths, predicate_to_satisfy)}]
-           -> std::optional<fs::path> {
-      return result_it != end ? std::optional{*result_it} : std::nullopt;
-    }();
+      return moved;
+    });
   }
 
-  auto make_valid_candidate(const fs::path& target) -> std::optional<fs::path>
+  // An operation's result and, for a completed move, where the file landed.
+  // A failed cross-device copy keeps the "(N)" name it was copying to, so
+  // the report names the target that was actually tried.
+  struct move_outcome
   {
-    return find_valid_candidate(make_candidate_paths(build_candidate(target)));
-  }
+    operation_result result;
+    fs::path         landed{};
+  };
 
-  auto resolve_collision(const fs::path& target) -> fs::path
+  // Where EXDEV moves go once execution_options::cross_device is on: copied in
+  // place below the threshold, handed to the transfer pool from it upwards.
+  // Passed as nullptr when the fallback is off.
+  struct cross_device_route
   {
-    return does_target_exist(target)
-                .or_else([&target] { return make_valid_candidate(target); })
-                .value_or(target);
-  }
+    detail::transfer_pool& pool;
+    std::uint64_t          large_file_bytes;
+  };
 
-  auto ensure_directory(const fs::path& dir) -> VoidResult
+  // From the scan when it brought metadata, else one stat
+  auto source_size(const successful_operation& op) -> Result<std::uint64_t>
   {
-    return safe_fs::create_directories(dir);
+    if ( op.metadata.known )
+      return op.metadata.size;
+
+    const auto stamp{safe_fs::stamp(op.source)};
+    if ( not stamp )
+      return std::unexpected{stamp.error()};
+
+    return stamp->size;
   }
 
-  auto perform_move(const successful_operation& op) -> VoidResult
+  auto move_across(
+              execution_context&          context,
+              const successful_operation& op,
+              const cross_device_route&   route
+  ) -> move_outcome
   {
-    return ensure_directory(op.destination.parent_path()).and_then([&op] {
-      return safe_fs::rename(op.source, resolve_collision(op.destination));
-    });
+    const auto size{source_size(op)};
+    if ( not size )
+      return {.result{operation_result::create_failure(size.error())}};
+
+    // The copy creates its target exclusively, so the name is settled up front
+    auto target{successful_operation{
+         .source{op.source},
+         .destination{context.resolve_collision(op.destination)},
+         .bucket_name{op.bucket_name},
+         .metadata{op.metadata},
+    }};
+    context.record_arrival(target.destination);
+
+    if ( *size >= route.large_file_bytes )
+    {
+      route.pool.submit(std::move(target));
+      return {.result{operation_result::create_deferred()}};
+    }
+
+    const auto moved{detail::move_across_devices(target.source, target.destination)};
+    if ( not moved )
+      return {
+           .result{operation_result::create_failure(moved.error())},
+           .landed{std::move(target.destination)},
+      };
+
+    return {
+         .result{operation_result::create_success()},
+         .landed{std::move(target.destination)},
+    };
   }
 
-  auto process_operation(const successful_operation& op) -> operation_result
+  auto process_operation(
+              execution_context&          context,
+              const successful_operation& op,
+              const cross_device_route*   route
+  ) -> move_outcome
   {
     if ( op.source == op.destination )
-      return operation_result::create_skipped();
+      return {.result{operation_result::create_skipped()}};
 
-    return [result{perform_move(op)}, &op] {
-      return result.has_value()
-                         ? operation_result::create_success()
-                         : operation_result::create_failure(op, result.error());
-    }();
+    auto moved{perform_move(context, op)};
+    if ( moved )
+      return {
+           .result{operation_result::create_success()},
+           .landed{std::move(*moved)},
+      };
+
+    if ( moved.error() == std::errc::cross_device_link and route )
+      return move_across(context, op, *route);
+
+    return {.result{operation_result::create_failure(moved.error())}};
   }
 
-  auto accumulate_reports(execution_report&& report, const operation_result& result)
-              -> execution_report
+  // Only a failure needs op's paths. An rvalue op (materialized from an indexed
+  // plan just for this call) hands them over; a movement_plan's are copied.
+  // A non-empty tried replaces op's destination as the one reported.
+  template <typename Op>
+  auto accumulate_reports(
+              execution_report&&     report,
+              const operation_result result,
+              Op&&                   op,
+              const fs::path&        tried = {}
+  ) -> execution_report
   {
     using enum operation_status;
 
@@ -122,23 +243,664 @@ namespace
     case failure:
       return std::move(report)
                   .with_processed()
-                  .with_failure(result.failure()->get())
+                  .with_failure(failed_operation{
+                       .source{std::forward<Op>(op).source},
+                       .destination{tried.empty()
+                                    ? fs::path{std::forward<Op>(op).destination}
+                                    : tried},
+                       .error{result.error()},
+                  })
                   .finalize();
     case skipped: return std::move(report).with_processed().finalize();
+    case deferred: return std::move(report);
     }
 
     std::unreachable();
   }
+
+  template <rng::input_range R>
+  auto run_operations(
+              execution_context&        context,
+              R&&                       operations,
+              const cross_device_route* route = nullptr
+  ) -> execution_report
+  {
+    auto step{[&context, route](
+                          execution_report&&          report,
+                          const successful_operation& op
+              ) {
+      const auto outcome{process_operation(context, op, route)};
+      return accumulate_reports(
+                  std::move(report),
+                  outcome.result,
+                  op,
+                  outcome.landed
+      );
+    }};
+
+    return rng::fold_left(
+                std::forward<R>(operations),
+                execution_report::start(),
+                step
+    );
+  }
+
+  // What indexed runs thread down to every operation; either may be null
+  struct run_hooks
+  {
+    const cross_device_route* route{nullptr};
+    journal::journal_writer*  journal{nullptr};
+  };
+
+  // Only a move that hit a collision journals its name; an empty one stands
+  // for the planned destination
+  auto journal_move(
+              journal::journal_writer&    journal,
+              const std::size_t           idx,
+              const successful_operation& op,
+              const fs::path&             landed
+  ) -> void
+  {
+    if ( landed.native() == op.destination.native() )
+    {
+      journal.record(idx, {});
+      return;
+    }
+
+    const auto name{landed.filename()};
+    journal.record(idx, name.native());
+  }
+
+  // Operations of indexed plans are materialized only as they run, and owned
+  // by this step, so a failure moves its paths into the report. Mapped plans
+  // can tell an in-place operation from the mapped strings alone, and a
+  // resumed journal knows what an earlier run finished, so those are skipped
+  // without building any path.
+  auto process_owned(
+              execution_report&&     report,
+              execution_context&     context,
+              successful_operation&& op,
+              const std::size_t      idx,
+              const run_hooks&       hooks
+  ) -> execution_report
+  {
+    const auto outcome{process_operation(context, op, hooks.route)};
+    if ( hooks.journal and outcome.result.status() == operation_status::success )
+      journal_move(*hooks.journal, idx, op, outcome.landed);
+
+    return accumulate_reports(
+                std::move(report),
+                outcome.result,
+                std::move(op),
+                outcome.landed
+    );
+  }
+
+  auto is_settled(
+              const compact_plan&,
+              const std::size_t              idx,
+              const journal::journal_writer* journal
+  ) -> bool
+  {
+    return journal and journal->done(idx);
+  }
+
+  auto is_settled(
+              const mapped_plan&             plan,
+              const std::size_t              idx,
+              const journal::journal_writer* journal
+  ) -> bool
+  {
+    return plan.is_in_place(idx) or (journal and journal->done(idx));
+  }
+
+  template <typename IndexedPlan>
+  auto process_indexed(
+              execution_report&& report,
+              execution_context& context,
+              const IndexedPlan& plan,
+              const std::size_t  idx,
+              const run_hooks&   hooks
+  ) -> execution_report
+  {
+    if ( is_settled(plan, idx, hooks.journal) )
+      return std::move(report).with_processed().finalize();
+
+    auto op{plan.operation(idx)};
+    return process_owned(std::move(report), context, std::move(op), idx, hooks);
+  }
+
+  template <typename IndexedPlan, rng::input_range Indices>
+  auto run_indexed(
+              execution_context& context,
+              const IndexedPlan& plan,
+              Indices&&          indices,
+              const run_hooks&   hooks = {}
+  ) -> execution_report
+  {
+    auto step{[&context, &plan, &hooks](
+                          execution_report&& report,
+                          const std::size_t  idx
+              ) {
+      return process_indexed(std::move(report), context, plan, idx, hooks);
+    }};
+
+    return rng::fold_left(
+                std::forward<Indices>(indices),
+                execution_report::start(),
+                step
+    );
+  }
+
+  using operation_span = std::span<const successful_operation>;
+  using shard          = std::vector<operation_span>;
+  using index_shard    = std::vector<std::size_t>;
+
+  // generate() emits each bucket as one contiguous run. Runs are still grouped
+  // by bucket here, so a bucket whose operations are interleaved with others
+  // lands in a single shard, and no two workers ever share a destination
+  // directory or its collision cache.
+  auto shard_by_bucket(const movement_plan& plan) -> std::vector<shard>
+  {
+    auto same_bucket{[](const auto& a, const auto& b) {
+      return a.bucket_name == b.bucket_name;
+    }};
+
+    auto shards{std::vector<shard>{}};
+    auto shard_of{std::unordered_map<std::string_view, std::size_t>{}};
+
+    for ( auto&& run : plan.operations | vws::chunk_by(same_bucket) )
+    {
+      const auto [slot, inserted]{
+           shard_of.try_emplace(run.front().bucket_name, shards.size())
+      };
+
+      if ( inserted )
+        shards.emplace_back();
+
+      shards[slot->second].emplace_back(run);
+    }
+
+    return shards;
+  }
+
+  auto resolve_worker_count(const std::size_t requested) -> std::size_t
+  {
+    const auto hardware{std::size_t{std::thread::hardware_concurrency()}};
+    return requested != 0 ? requested : std::max<std::size_t>(1, hardware);
+  }
+
+  // Compact and mapped plans already carry a dense bucket id per operation
+  template <typename IndexedPlan>
+  auto shard_by_bucket(const IndexedPlan& plan) -> std::vector<index_shard>
+  {
+    auto shards{std::vector<index_shard>(plan.bucket_count())};
+    for ( auto idx{std::size_t{0}}; idx < plan.size(); ++idx )
+      shards[plan.bucket_of(idx)].push_back(idx);
+
+    std::erase_if(shards, [](const auto& shard) { return shard.empty(); });
+    return shards;
+  }
+
+  // Workers pull whole shards off a shared counter, each with its own context
+  // and report. Reports are merged in shard order so the failure list does not
+  // depend on scheduling.
+  template <typename Shard, typename RunShard>
+  auto execute_shards(
+              const std::vector<Shard>&        shards,
+              const std::size_t                workers,
+              std::pmr::memory_resource* const memory,
+              const RunShard&                  run_shard
+  ) -> execution_report
+  {
+    auto reports{report_collector{shards.size()}};
+    auto next_shard{std::atomic<std::size_t>{0}};
+
+    {
+      auto pool{std::vector<std::jthread>{}};
+      pool.reserve(workers);
+
+      for ( auto worker{std::size_t{0}}; worker < workers; ++worker )
+      {
+        pool.emplace_back([&shards, &reports, &next_shard, memory, &run_shard] {
+          for ( auto idx{next_shard.fetch_add(1)}; idx < shards.size();
+                idx = next_shard.fetch_add(1) )
+          {
+            auto context{execution_context{memory}};
+            reports.slot(idx) = run_shard(context, shards[idx]);
+          }
+        });
+      }
+    } // jthreads join here
+
+    return std::move(reports).merge();
+  }
+
+  // Runs body with the route options ask for, then waits for the transfer
+  // pool and folds its moves into body's report. A journaled run copies every
+  // file in place, so each move it records has really completed.
+  template <typename Body>
+  auto with_transfers(const execution_options& options, const Body& body)
+              -> execution_report
+  {
+    if ( not options.cross_device )
+      return body(nullptr);
+
+    const auto workers{std::max<std::size_t>(1, options.transfer_workers)};
+    auto       pool{detail::transfer_pool{workers, 2 * workers}};
+    const auto threshold{
+         options.journal ? std::numeric_limits<std::uint64_t>::max()
+                         : options.large_file_bytes
+    };
+    const auto route{cross_device_route{
+         .pool = pool,
+         .large_file_bytes = threshold,
+    }};
+
+    auto report{body(&route)};
+    return std::move(report).with_report(pool.drain()).finalize();
+  }
+
+  template <typename IndexedPlan>
+  auto execute_indexed(const IndexedPlan& plan, const execution_options& options)
+              -> execution_report
+  {
+    // The ring keeps every operation's paths alive for the whole run. It
+    // reports no per-operation names, so journaled runs stay blocking.
+    if ( options.backend == execution_backend::io_uring and not options.journal )
+      return detail::execute_with_io_uring(plan.to_movement_plan(), options);
+
+    const auto shards{shard_by_bucket(plan)};
+    const auto workers{
+         std::min(resolve_worker_count(options.worker_count), shards.size())
+    };
+
+    return with_transfers(options, [&](const cross_device_route* route) {
+      const auto hooks{run_hooks{.route = route, .journal = options.journal}};
+
+      if ( workers <= 1 )
+      {
+        auto context{execution_context{options.memory}};
+        const auto all{vws::iota(std::size_t{0}, plan.size())};
+        return run_indexed(context, plan, all, hooks);
+      }
+
+      return execute_shards(
+                  shards,
+                  workers,
+                  options.memory,
+                  [&plan, &hooks](auto& context, const index_shard& indices) {
+                    return run_indexed(context, plan, indices, hooks);
+                  }
+      );
+    });
+  }
+
+  // The async executor runs the same moves as coroutines on an io_loop. Every
+  // one of them resumes on the loop's thread, so they all share one context;
+  // two moves racing for a name are still settled by the kernel, since no
+  // rename ever replaces.
+  auto move_no_replace_async(
+              async::io_loop&             loop,
+              execution_context&          context,
+              const successful_operation& op
+  ) -> async::task<Result<fs::path>>
+  {
+    const auto source_dir{context.handle_for(op.source.parent_path())};
+    if ( not source_dir )
+      co_return std::unexpected{source_dir.error()};
+
+    const auto bucket_dir{context.handle_for(op.destination.parent_path())};
+    if ( not bucket_dir )
+      co_return std::unexpected{bucket_dir.error()};
+
+    const auto source_name{op.source.filename()};
+    auto       target{op.destination};
+    auto       target_name{target.filename()};
+    auto       moved{co_await loop.rename_at(
+                **source_dir,
+                source_name,
+                **bucket_dir,
+                target_name
+    )};
+
+    while ( not moved and moved.error() == std::errc::file_exists )
+    {
+      auto candidate{context.names_for(target.parent_path())
+                                 .claim_candidate(op.destination)};
+      if ( not candidate )
+        co_return std::unexpected{moved.error()};
+
+      target      = std::move(*candidate);
+      target_name = target.filename();
+      moved       = co_await loop.rename_at(
+                  **source_dir,
+                  source_name,
+                  **bucket_dir,
+                  target_name
+      );
+    }
+
+    if ( not moved )
+      co_return std::unexpected{moved.error()};
+
+    context.record_arrival(target);
+    co_return std::move(target);
+  }
+
+  // Collisions are resolved here, on the loop thread that owns the caches;
+  // only the rename or copy itself goes to an I/O thread
+  auto move_by_path_async(
+              async::io_loop&             loop,
+              execution_context&          context,
+              const successful_operation& op
+  ) -> async::task<Result<fs::path>>
+  {
+    auto target{context.resolve_collision(op.destination)};
+    auto moved{co_await loop.offload([&op, &target] {
+      return safe_fs::rename_no_replace(op.source, target);
+    })};
+
+    for ( auto attempt{1};
+          not moved and moved.error() == std::errc::file_exists
+          and attempt < max_candidate_index;
+          ++attempt )
+    {
+      target = context.resolve_collision(op.destination);
+      moved  = co_await loop.offload([&op, &target] {
+        return safe_fs::rename_no_replace(op.source, target);
+      });
+    }
+
+    if ( not moved )
+      co_return std::unexpected{moved.error()};
+
+    co_return std::move(target);
+  }
+
+  auto move_across_async(
+              async::io_loop&             loop,
+              execution_context&          context,
+              const successful_operation& op
+  ) -> async::task<move_outcome>
+  {
+    // The copy creates its target exclusively, so the name is settled up front
+    auto target{context.resolve_collision(op.destination)};
+    context.record_arrival(target);
+
+    const auto moved{co_await loop.offload([&op, &target] {
+      return detail::move_across_devices(op.source, target);
+    })};
+
+    if ( not moved )
+      co_return {
+           .result{operation_result::create_failure(moved.error())},
+           .landed{std::move(target)},
+      };
+
+    co_return {
+         .result{operation_result::create_success()},
+         .landed{std::move(target)},
+    };
+  }
+
+  auto process_async(
+              async::io_loop&             loop,
+              execution_context&          context,
+              const successful_operation& op,
+              const bool                  cross_device
+  ) -> async::task<move_outcome>
+  {
+    if ( op.source == op.destination )
+      co_return {.result{operation_result::create_skipped()}};
+
+    if ( const auto ready{context.ensure_bucket(op)}; not ready )
+      co_return {.result{operation_result::create_failure(ready.error())}};
+
+    auto moved{co_await move_no_replace_async(loop, context, op)};
+    if ( needs_path_fallback(moved) )
+      moved = co_await move_by_path_async(loop, context, op);
+
+    if ( moved )
+      co_return {
+           .result{operation_result::create_success()},
+           .landed{std::move(*moved)},
+      };
+
+    if ( moved.error() == std::errc::cross_device_link and cross_device )
+      co_return co_await move_across_async(loop, context, op);
+
+    co_return {.result{operation_result::create_failure(moved.error())}};
+  }
+
+  // One operation, materialized and owned by its coroutine, folded into the
+  // shared report once it completes
+  template <typename IndexedPlan>
+  auto run_one_async(
+              async::io_loop&          loop,
+              execution_context&       context,
+              const IndexedPlan&       plan,
+              const std::size_t        idx,
+              const execution_options& options,
+              execution_report&        report
+  ) -> async::task<void>
+  {
+    auto       op{plan.operation(idx)};
+    const auto outcome{
+         co_await process_async(loop, context, op, options.cross_device)
+    };
+
+    if ( options.journal and outcome.result.status() == operation_status::success )
+      journal_move(*options.journal, idx, op, outcome.landed);
+
+    report = accumulate_reports(
+                std::move(report),
+                outcome.result,
+                std::move(op),
+                outcome.landed
+    );
+  }
+
+  template <typename IndexedPlan>
+  auto execute_async(
+              const IndexedPlan&       plan,
+              const execution_options& options,
+              async::io_loop&          loop
+  ) -> async::task<execution_report>
+  {
+    auto context{execution_context{options.memory}};
+    auto report{execution_report::start()};
+    auto group{async::task_group{loop, loop.max_in_flight()}};
+
+    for ( auto idx{std::size_t{0}}; idx < plan.size(); ++idx )
+    {
+      if ( is_settled(plan, idx, options.journal) )
+      {
+        report = std::move(report).with_processed().finalize();
+        continue;
+      }
+
+      co_await group.spawn(run_one_async(loop, context, plan, idx, options, report));
+    }
+
+    co_await group.join();
+    co_return std::move(report);
+  }
+
+  // A dry-run move: claims the target (or its first free "(N)" sibling) in the
+  // destination's name cache and rewrites op.destination to it. Mirrors
+  // move_no_replace, which walks the same cache once rename_at says EEXIST.
+  auto simulate_move(execution_context& context, successful_operation& op)
+              -> operation_result
+  {
+    if ( op.source == op.destination )
+      return operation_result::create_skipped();
+
+    auto&      names{context.names_for(op.destination.parent_path())};
+    const auto name{op.destination.filename().string()};
+
+    if ( names.is_free(name) )
+    {
+      names.insert(name);
+      return operation_result::create_success();
+    }
+
+    auto candidate{names.claim_candidate(op.destination)};
+    if ( not candidate )
+      return operation_result::create_failure(
+                  std::make_error_code(std::errc::file_exists)
+      );
+
+    op.destination = std::move(*candidate);
+    return operation_result::create_success();
+  }
+
+  // Fills resolved[idx] for every idx; shards own disjoint indices, so parallel
+  // workers never write the same element
+  template <typename IndexedPlan, rng::input_range Indices>
+  auto simulate_indexed(
+              execution_context&                    context,
+              const IndexedPlan&                    plan,
+              Indices&&                             indices,
+              const std::span<successful_operation> resolved
+  ) -> execution_report
+  {
+    auto report{execution_report::start()};
+
+    for ( const std::size_t idx : indices )
+    {
+      auto&      op{resolved[idx]};
+      op = plan.operation(idx);
+      const auto result{simulate_move(context, op)};
+      report = accumulate_reports(std::move(report), result, op);
+    }
+
+    return report;
+  }
+
+  template <typename IndexedPlan>
+  auto dry_run_indexed(const IndexedPlan& plan, const execution_options& options)
+              -> dry_run_result
+  {
+    auto       resolved{std::vector<successful_operation>(plan.size())};
+    const auto shards{shard_by_bucket(plan)};
+    const auto workers{
+         std::min(resolve_worker_count(options.worker_count), shards.size())
+    };
+
+    auto report{[&] {
+      if ( workers <= 1 )
+      {
+        auto context{execution_context{options.memory}};
+        const auto all{vws::iota(std::size_t{0}, plan.size())};
+        return simulate_indexed(context, plan, all, resolved);
+      }
+
+      return execute_shards(
+                  shards,
+                  workers,
+                  options.memory,
+                  [&plan, &resolved](auto& context, const index_shard& indices) {
+                    return simulate_indexed(context, plan, indices, resolved);
+                  }
+      );
+    }()};
+
+    return {
+         .resolved{.operations{std::move(resolved)}},
+         .report{std::move(report)},
+    };
+  }
 } // namespace
 
 namespace fs_ops::executor
 {
   auto execute_plan(const movement_plan& plan) -> execution_report
   {
-    return rng::fold_left(
-                plan.operations | vws::transform(process_operation),
-                execution_report::start(),
-                accumulate_reports
-    );
+    auto context{execution_context{}};
+    return run_operations(context, plan.operations);
+  }
+
+  auto execute_plan(const movement_plan& plan, const execution_options& options)
+              -> execution_report
+  {
+    // The ring already keeps thousands of operations in flight from one thread
+    if ( options.backend == execution_backend::io_uring )
+      return detail::execute_with_io_uring(plan, options);
+
+    const auto shards{shard_by_bucket(plan)};
+    const auto workers{
+         std::min(resolve_worker_count(options.worker_count), shards.size())
+    };
+
+    return with_transfers(options, [&](const cross_device_route* route) {
+      if ( workers <= 1 )
+      {
+        auto context{execution_context{options.memory}};
+        return run_operations(context, plan.operations, route);
+      }
+
+      return execute_shards(
+                  shards,
+                  workers,
+                  options.memory,
+                  [route](auto& context, const shard& runs) {
+                    return run_operations(context, runs | vws::join, route);
+                  }
+      );
+    });
+  }
+
+  auto execute_plan(const compact_plan& plan) -> execution_report
+  {
+    return execute_plan(plan, {.worker_count = 1});
+  }
+
+  auto execute_plan(const compact_plan& plan, const execution_options& options)
+              -> execution_report
+  {
+    return execute_indexed(plan, options);
+  }
+
+  auto execute_plan(const compact_plan& plan, execution_context& context)
+              -> execution_report
+  {
+    return run_indexed(context, plan, vws::iota(std::size_t{0}, plan.size()));
+  }
+
+  auto execute_plan(const mapped_plan& plan, const execution_options& options)
+              -> execution_report
+  {
+    return execute_indexed(plan, options);
+  }
+
+  auto execute_plan(
+              const compact_plan&      plan,
+              const execution_options& options,
+              async::io_loop&          loop
+  ) -> async::task<execution_report>
+  {
+    return execute_async(plan, options, loop);
+  }
+
+  auto execute_plan(
+              const mapped_plan&       plan,
+              const execution_options& options,
+              async::io_loop&          loop
+  ) -> async::task<execution_report>
+  {
+    return execute_async(plan, options, loop);
+  }
+
+  auto dry_run(const compact_plan& plan, const execution_options& options)
+              -> dry_run_result
+  {
+    return dry_run_indexed(plan, options);
+  }
+
+  auto dry_run(const mapped_plan& plan, const execution_options& options)
+              -> dry_run_result
+  {
+    return dry_run_indexed(plan, options);
   }
 } // namespace fs_ops::executor
@@ -0,0 +1,308 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(FILEJANITOR_HAS_IO_URING)
+#  include <liburing.h>
+#endif
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+using namespace fs_ops;
+using namespace fs_ops::async;
+
+#if defined(FILEJANITOR_HAS_IO_URING)
+namespace
+{
+  // Submission queue size; a full queue is submitted before the next rename
+  constexpr unsigned ring_entries{4096};
+
+  // How long a ring wait may hold back a coroutine an I/O thread just posted
+  constexpr long long posted_poll_ns{1'000'000};
+} // namespace
+#endif
+
+namespace fs_ops::async
+{
+  struct io_loop::ring
+  {
+#if defined(FILEJANITOR_HAS_IO_URING)
+    io_uring                       queue{};
+    std::size_t                    queued{0};      // prepared, not yet submitted
+    std::size_t                    in_flight{0};   // submitted, not yet reaped
+    std::vector<rename_awaitable*> unsubmitted{};  // the queued ones, in order
+
+    auto busy() const noexcept -> bool { return queued + in_flight > 0; }
+
+    // io_uring_submit's result; the SQEs it took move from queued to in flight
+    auto submit_queued() -> int
+    {
+      const auto rc{io_uring_submit(&queue)};
+      if ( rc > 0 )
+      {
+        const auto taken{std::min(static_cast<std::size_t>(rc), queued)};
+        queued -= taken;
+        in_flight += taken;
+        unsubmitted.erase(
+                    unsubmitted.begin(),
+                    unsubmitted.begin() + static_cast<std::ptrdiff_t>(taken)
+        );
+      }
+      return rc;
+    }
+#else
+    auto busy() const noexcept -> bool { return false; }
+#endif
+  };
+
+  io_loop::io_loop(const loop_options& options)
+      : max_in_flight_{std::max<std::size_t>(1, options.max_in_flight)},
+        ring_{},
+        jobs_{max_in_flight_}
+  {
+#if defined(FILEJANITOR_HAS_IO_URING)
+    if ( options.backend == io_backend::io_uring )
+    {
+      auto candidate{std::make_unique<ring>()};
+      if ( io_uring_queue_init(ring_entries, &candidate->queue, 0) == 0 )
+        ring_ = std::move(candidate);
+    }
+#endif
+
+    const auto threads{std::max<std::size_t>(1, options.io_threads)};
+    threads_.reserve(threads);
+
+    for ( auto thread{std::size_t{0}}; thread < threads; ++thread )
+    {
+      threads_.emplace_back([this] {
+        while ( auto work{jobs_.pop()} )
+          (*work)();
+      });
+    }
+  }
+
+  io_loop::~io_loop()
+  {
+    jobs_.close();
+    threads_.clear(); // joins once the queue is drained
+
+#if defined(FILEJANITOR_HAS_IO_URING)
+    if ( ring_ )
+      io_uring_queue_exit(&ring_->queue);
+#endif
+  }
+
+  auto io_loop::backend() const noexcept -> io_backend
+  {
+    return ring_ ? io_backend::io_uring : io_backend::thread_pool;
+  }
+
+  auto io_loop::max_in_flight() const noexcept -> std::size_t
+  {
+    return max_in_flight_;
+  }
+
+  auto io_loop::post(const std::coroutine_handle<> waiting) -> void
+  {
+    {
+      const auto lock{std::scoped_lock{mutex_}};
+      ready_.push_back(waiting);
+    }
+    posted_.notify_one();
+  }
+
+  auto io_loop::submit(job work) -> void
+  {
+    offloaded_.fetch_add(1, std::memory_order_relaxed);
+
+    auto counted{[this, work{std::move(work)}] mutable {
+      work();
+      offloaded_.fetch_sub(1, std::memory_order_relaxed);
+    }};
+
+    [[maybe_unused]] const auto queued{jobs_.push(std::move(counted))};
+  }
+
+  auto io_loop::rename_awaitable::await_suspend(
+              const std::coroutine_handle<> waiting
+  ) -> void
+  {
+    waiting_ = waiting;
+    loop_.submit_rename(*this);
+  }
+
+  auto io_loop::submit_rename(rename_awaitable& rename) -> void
+  {
+#if defined(FILEJANITOR_HAS_IO_URING)
+    if ( ring_ )
+    {
+      auto* sqe{io_uring_get_sqe(&ring_->queue)};
+      if ( not sqe and ring_->submit_queued() > 0 )
+        sqe = io_uring_get_sqe(&ring_->queue);
+
+      if ( sqe )
+      {
+        instrumentation::count(instrumentation::counter::rename_calls);
+        io_uring_prep_renameat(
+                    sqe,
+                    rename.from_dir_.native(),
+                    rename.from_name_.c_str(),
+                    rename.to_dir_.native(),
+                    rename.to_name_.c_str(),
+                    RENAME_NOREPLACE
+        );
+        io_uring_sqe_set_data(sqe, &rename);
+        ++ring_->queued;
+        ring_->unsubmitted.push_back(&rename);
+        return;
+      }
+    }
+#endif
+
+    rename_on_thread(rename);
+  }
+
+  auto io_loop::rename_on_thread(rename_awaitable& rename) -> void
+  {
+    submit([&rename] {
+      rename.result_ = safe_fs::rename_at(
+                  rename.from_dir_,
+                  rename.from_name_,
+                  rename.to_dir_,
+                  rename.to_name_
+      );
+      rename.loop_.post(rename.waiting_);
+    });
+  }
+
+  auto io_loop::wait_and_resume() -> void
+  {
+    const auto ring_busy{ring_ and ring_->busy()};
+
+    take_posted(not ring_busy);
+    for ( const auto waiting : resuming_ )
+      waiting.resume();
+
+    const auto resumed{not resuming_.empty()};
+    resuming_.clear();
+
+    if ( ring_busy )
+      reap_ring(not resumed);
+  }
+
+  auto io_loop::take_posted(const bool block) -> void
+  {
+    auto lock{std::unique_lock{mutex_}};
+    if ( block )
+      posted_.wait(lock, [this] { return not ready_.empty(); });
+
+    resuming_.swap(ready_);
+  }
+
+  auto io_loop::abandon_ring() -> void
+  {
+#if defined(FILEJANITOR_HAS_IO_URING)
+    // Exiting drops the SQEs that were never submitted, so none of these can
+    // still run on the ring as well
+    auto stranded{std::move(ring_->unsubmitted)};
+    io_uring_queue_exit(&ring_->queue);
+    ring_.reset();
+
+    for ( auto* const rename : stranded )
+      rename_on_thread(*rename);
+#endif
+  }
+
+  // Submits what is queued, then resumes every coroutine whose rename
+  // completed. Blocking waits are bounded while I/O threads are still busy,
+  // since what they post does not wake the ring. A submission that fails with
+  // nothing in flight would fail the same way every round, so the ring is
+  // abandoned instead.
+  auto io_loop::reap_ring([[maybe_unused]] const bool block) -> void
+  {
+#if defined(FILEJANITOR_HAS_IO_URING)
+    auto& state{*ring_};
+
+    if ( state.queued > 0 and state.submit_queued() <= 0 and state.in_flight == 0 )
+    {
+      abandon_ring();
+      return;
+    }
+
+    if ( block and state.in_flight > 0 )
+    {
+      io_uring_cqe* cqe{nullptr};
+      if ( offloaded_.load(std::memory_order_relaxed) == 0 )
+      {
+        [[maybe_unused]] const auto waited{io_uring_wait_cqe(&state.queue, &cqe)};
+      }
+      else
+      {
+        auto timeout{__kernel_timespec{.tv_sec = 0, .tv_nsec = posted_poll_ns}};
+        [[maybe_unused]] const auto waited{
+             io_uring_wait_cqe_timeout(&state.queue, &cqe, &timeout)
+        };
+      }
+    }
+
+    io_uring_cqe* cqe{nullptr};
+    while ( state.in_flight > 0 and io_uring_peek_cqe(&state.queue, &cqe) == 0 )
+    {
+      auto& rename{*static_cast<rename_awaitable*>(io_uring_cqe_get_data(cqe))};
+      rename.result_ = cqe->res == 0
+                       ? VoidResult{}
+                       : VoidResult{std::unexpected{
+                              std::error_code{-cqe->res, std::system_category()}}};
+
+      io_uring_cqe_seen(&state.queue, cqe);
+      --state.in_flight;
+      rename.waiting_.resume();
+    }
+#endif
+  }
+
+  task_group::task_group(io_loop& loop, const std::size_t limit) noexcept
+      : loop_{loop},
+        limit_{std::max<std::size_t>(1, limit)}
+  {}
+
+  auto task_group::run_detached(task<void> work, task_group& group) -> detached
+  {
+    co_await std::move(work);
+    group.finished();
+  }
+
+  auto task_group::start(task<void> work) -> void
+  {
+    ++running_;
+    run_detached(std::move(work), *this);
+  }
+
+  // Always resumed through the loop, never from here: a finish inside a
+  // spawn would otherwise resume the spawner from within itself
+  auto task_group::finished() -> void
+  {
+    --running_;
+    if ( waiting_ and running_ < wake_below_ )
+      loop_.post(std::exchange(waiting_, {}));
+  }
+} // namespace fs_ops::async
@@ -0,0 +1,556 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <unistd.h>
+#endif
+
+#include <xxhash.h>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs  = std::filesystem;
+namespace vws = std::views;
+
+using namespace fs_ops;
+using namespace fs_ops::journal;
+
+namespace
+{
+  constexpr auto journal_magic{
+       std::array<char, 8>{'F', 'J', 'J', 'R', 'N', 'L', 0, 0}
+  };
+  constexpr std::uint32_t journal_version{1};
+
+  // On-disk sizes and field offsets; independent of any struct layout
+  constexpr std::size_t header_size{32};
+  constexpr std::size_t record_header_size{12};
+
+  struct header_field
+  {
+    static constexpr std::size_t version{8};
+    static constexpr std::size_t path_length{12};
+    static constexpr std::size_t op_count{16};
+    static constexpr std::size_t fingerprint{24};
+  };
+
+  constexpr std::size_t read_buffer_size{1024UZ * 1024UZ};
+
+  auto corrupt_journal() -> std::unexpected<std::error_code>
+  {
+    return std::unexpected{std::make_error_code(std::errc::bad_message)};
+  }
+
+  auto last_error() -> std::error_code
+  {
+    return {errno, std::system_category()};
+  }
+
+  template <typename T>
+  auto read_at(const std::string& bytes, const std::size_t offset) noexcept -> T
+  {
+    auto value{T{}};
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  auto put(std::string& out, const T value) -> void
+  {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  // offset + length <= limit, without overflowing on corrupt input
+  auto fits(
+              const std::uint64_t offset,
+              const std::uint64_t length,
+              const std::uint64_t limit
+  ) -> bool
+  {
+    return offset <= limit and length <= limit - offset;
+  }
+
+  auto read_whole(const fs::path& file) -> Result<std::string>
+  {
+    auto in{std::ifstream{file, std::ios::binary | std::ios::ate}};
+    if ( not in )
+      return std::unexpected{std::make_error_code(std::errc::io_error)};
+
+    auto bytes{std::string(static_cast<std::size_t>(in.tellg()), '\0')};
+    in.seekg(0);
+    in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if ( not in )
+      return std::unexpected{std::make_error_code(std::errc::io_error)};
+
+    return bytes;
+  }
+
+  // Unbuffered, so each batch is exactly one write() and nothing sits in stdio
+  auto open_unbuffered(const fs::path& file, const char* const mode)
+              -> Result<std::FILE*>
+  {
+    auto* const handle{std::fopen(file.c_str(), mode)};
+    if ( not handle )
+      return std::unexpected{last_error()};
+
+    std::setvbuf(handle, nullptr, _IONBF, 0);
+    return handle;
+  }
+
+  // The source name may have been taken again since the move; that file stays,
+  // since neither the rename nor the copy replaces an existing name
+  auto move_back(const fs::path& landed, const fs::path& source) -> VoidResult
+  {
+    auto moved{safe_fs::rename_no_replace(landed, source)};
+    if ( not moved and moved.error() == std::errc::cross_device_link )
+      return executor::detail::move_across_devices(landed, source);
+
+    return moved;
+  }
+
+  // A rerun after a partial undo finds the entries it already restored this way
+  auto already_moved_back(const fs::path& landed, const fs::path& source) -> bool
+  {
+    return not safe_fs::exists(landed) and safe_fs::exists(source);
+  }
+
+  // Where a move the journal never heard of ended up: its planned destination,
+  // else the first "(N)" sibling (in the order collision resolution tries them)
+  // that is the very file the plan scanned, by device and inode, and that no
+  // other entry claims. A name merely existing proves nothing: a file may have
+  // sat there before the run, or the source may have been deleted instead of
+  // moved. Hard links share an inode, so those are matched up in plan order.
+  using claimed_names = std::unordered_set<std::string>;
+
+  auto find_landed_name(
+              const fs::path&      destination,
+              const file_metadata& source,
+              claimed_names&       claimed
+  ) -> std::optional<std::string>
+  {
+    const auto unclaimed{[&](const fs::path& candidate) {
+      if ( claimed.contains(candidate.string()) )
+        return false;
+
+      const auto found{safe_fs::stamp(candidate)};
+      return found and found->device == source.device
+             and found->inode == source.inode;
+    }};
+
+    if ( unclaimed(destination) )
+    {
+      claimed.emplace(destination.string());
+      return std::string{};
+    }
+
+    for ( auto idx{1}; idx < executor::max_candidate_index; ++idx )
+    {
+      const auto candidate{executor::candidate_name(destination, idx)};
+      if ( unclaimed(candidate) )
+      {
+        claimed.emplace(candidate.string());
+        return candidate.filename().string();
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  auto landed_path(const successful_operation& op, const journal_entry& entry)
+              -> fs::path
+  {
+    return entry.final_name.empty()
+           ? op.destination
+           : safe_fs::join(op.destination.parent_path(), {entry.final_name});
+  }
+} // namespace
+
+namespace fs_ops::journal
+{
+  auto read_journal(const fs::path& file) -> Result<journal_contents>
+  {
+    const auto read{read_whole(file)};
+    if ( not read )
+      return std::unexpected{read.error()};
+
+    const auto& bytes{*read};
+    const auto  size{std::uint64_t{bytes.size()}};
+    const auto  magic{std::string_view{journal_magic.data(), journal_magic.size()}};
+    if ( size < header_size or not bytes.starts_with(magic)
+         or read_at<std::uint32_t>(bytes, header_field::version) != journal_version )
+      return corrupt_journal();
+
+    const auto path_length{read_at<std::uint32_t>(bytes, header_field::path_length)};
+    if ( not fits(header_size, path_length, size) )
+      return corrupt_journal();
+
+    auto contents{journal_contents{
+         .plan_file{std::string_view{bytes.data() + header_size, path_length}},
+         .fingerprint{read_at<std::uint64_t>(bytes, header_field::fingerprint)},
+         .op_count{read_at<std::uint64_t>(bytes, header_field::op_count)},
+    }};
+
+    auto cursor{std::uint64_t{header_size + path_length}};
+    while ( fits(cursor, record_header_size, size) )
+    {
+      const auto index{read_at<std::uint64_t>(bytes, cursor)};
+      const auto length{read_at<std::uint32_t>(bytes, cursor + 8)};
+      const auto name_at{cursor + record_header_size};
+
+      // Torn by a crash mid-write: everything before it still counts
+      if ( not fits(name_at, length, size) )
+        break;
+
+      if ( index >= contents.op_count )
+        return corrupt_journal();
+
+      contents.entries.push_back({
+           .index{index},
+           .final_name{bytes.substr(name_at, length)},
+      });
+      cursor = name_at + length;
+    }
+
+    contents.intact_bytes = cursor;
+    return contents;
+  }
+
+  auto plan_fingerprint(const fs::path& plan_file) -> Result<std::uint64_t>
+  {
+    const auto state{std::unique_ptr<XXH3_state_t, decltype(&XXH3_freeState)>{
+         XXH3_createState(),
+         &XXH3_freeState
+    }};
+    if ( not state or XXH3_64bits_reset(state.get()) == XXH_ERROR )
+      return std::unexpected{std::make_error_code(std::errc::not_enough_memory)};
+
+    auto       buffer{std::vector<std::byte>(read_buffer_size)};
+    auto*      hashing{state.get()};
+    const auto read{safe_fs::read_chunks(
+                plan_file,
+                buffer,
+                [hashing](const std::span<const std::byte> chunk) {
+                  [[maybe_unused]] const auto updated{
+                       XXH3_64bits_update(hashing, chunk.data(), chunk.size())
+                  };
+                }
+    )};
+    if ( not read )
+      return std::unexpected{read.error()};
+
+    return XXH3_64bits_digest(hashing);
+  }
+
+  auto open_plan(const journal_contents& journal) -> Result<mapped_plan>
+  {
+    const auto fingerprint{plan_fingerprint(journal.plan_file)};
+    if ( not fingerprint )
+      return std::unexpected{fingerprint.error()};
+
+    if ( *fingerprint != journal.fingerprint )
+      return corrupt_journal();
+
+    auto plan{mapped_plan::open(journal.plan_file)};
+    if ( plan and plan->size() != journal.op_count )
+      return corrupt_journal();
+
+    return plan;
+  }
+
+  journal_writer::journal_writer(
+              std::FILE* const      file,
+              const journal_options options
+  ) noexcept
+      : file_{file},
+        options_{options}
+  {}
+
+  journal_writer::journal_writer(journal_writer&& other) noexcept
+      : file_{std::exchange(other.file_, nullptr)},
+        options_{other.options_},
+        batch_{std::move(other.batch_)},
+        batched_{std::exchange(other.batched_, 0)},
+        unsynced_{std::exchange(other.unsynced_, 0)},
+        error_{other.error_},
+        done_{std::move(other.done_)},
+        resumed_{other.resumed_},
+        mutex_{}
+  {}
+
+  auto journal_writer::operator=(journal_writer&& other) noexcept -> journal_writer&
+  {
+    if ( this != &other )
+    {
+      if ( file_ )
+      {
+        [[maybe_unused]] const auto synced{sync()};
+        std::fclose(file_);
+      }
+
+      file_     = std::exchange(other.file_, nullptr);
+      options_  = other.options_;
+      batch_    = std::move(other.batch_);
+      batched_  = std::exchange(other.batched_, 0);
+      unsynced_ = std::exchange(other.unsynced_, 0);
+      error_    = other.error_;
+      done_     = std::move(other.done_);
+      resumed_  = other.resumed_;
+    }
+    return *this;
+  }
+
+  journal_writer::~journal_writer()
+  {
+    if ( not file_ )
+      return;
+
+    [[maybe_unused]] const auto synced{sync()};
+    std::fclose(file_);
+  }
+
+  auto journal_writer::create(
+              const fs::path&       file,
+              const fs::path&       plan_file,
+              const mapped_plan&    plan,
+              const journal_options options
+  ) -> Result<journal_writer>
+  {
+    const auto fingerprint{plan_fingerprint(plan_file)};
+    if ( not fingerprint )
+      return std::unexpected{fingerprint.error()};
+
+    // Absolute, so a resume from another working directory finds it again
+    auto ec{std::error_code{}};
+    const auto plan_path{fs::absolute(plan_file, ec).string()};
+    if ( ec )
+      return std::unexpected{ec};
+
+    const auto handle{open_unbuffered(file, "wb")};
+    if ( not handle )
+      return std::unexpected{handle.error()};
+
+    auto writer{journal_writer{*handle, options}};
+
+    writer.batch_.append(journal_magic.data(), journal_magic.size());
+    put<std::uint32_t>(writer.batch_, journal_version);
+    put<std::uint32_t>(writer.batch_, static_cast<std::uint32_t>(plan_path.size()));
+    put<std::uint64_t>(writer.batch_, plan.size());
+    put<std::uint64_t>(writer.batch_, *fingerprint);
+    writer.batch_ += plan_path;
+
+    // The header is on disk before the first move can happen
+    writer.batched_ = 1;
+    if ( const auto synced{writer.sync()}; not synced )
+      return std::unexpected{synced.error()};
+
+    return writer;
+  }
+
+  auto journal_writer::resume(
+              const fs::path&         file,
+              const journal_contents& contents,
+              const journal_options   options
+  ) -> Result<journal_writer>
+  {
+    // A torn record would otherwise sit in front of everything appended now
+    auto ec{std::error_code{}};
+    fs::resize_file(file, contents.intact_bytes, ec);
+    if ( ec )
+      return std::unexpected{ec};
+
+    const auto handle{open_unbuffered(file, "ab")};
+    if ( not handle )
+      return std::unexpected{handle.error()};
+
+    auto writer{journal_writer{*handle, options}};
+    writer.done_.assign(contents.op_count, false);
+
+    // Whatever reconcile() recovered is not on disk yet
+    const auto recovered{std::min(contents.recovered, contents.entries.size())};
+    const auto first_recovered{contents.entries.size() - recovered};
+
+    for ( const auto& entry : contents.entries )
+    {
+      if ( not writer.done_[entry.index] )
+      {
+        writer.done_[entry.index] = true;
+        ++writer.resumed_;
+      }
+    }
+
+    for ( const auto& entry : contents.entries | vws::drop(first_recovered) )
+      writer.record(static_cast<std::size_t>(entry.index), entry.final_name);
+
+    if ( const auto synced{writer.sync()}; not synced )
+      return std::unexpected{synced.error()};
+
+    return writer;
+  }
+
+  auto journal_writer::record(
+              const std::size_t      index,
+              const std::string_view final_name
+  ) -> void
+  {
+    auto header{std::array<char, record_header_size>{}};
+    const auto at{std::uint64_t{index}};
+    const auto length{static_cast<std::uint32_t>(final_name.size())};
+    std::memcpy(header.data(), &at, sizeof(at));
+    std::memcpy(header.data() + sizeof(at), &length, sizeof(length));
+
+    const auto lock{std::scoped_lock{mutex_}};
+    batch_.append(header.data(), header.size()).append(final_name);
+
+    if ( ++batched_ >= options_.batch_records )
+      write_batch();
+  }
+
+  auto journal_writer::done(const std::size_t index) const noexcept -> bool
+  {
+    return index < done_.size() and done_[index];
+  }
+
+  auto journal_writer::resumed_count() const noexcept -> std::size_t
+  {
+    return resumed_;
+  }
+
+  auto journal_writer::sync() -> VoidResult
+  {
+    const auto lock{std::scoped_lock{mutex_}};
+    write_batch();
+    sync_file();
+
+    return error_ ? VoidResult{std::unexpected{error_}} : VoidResult{};
+  }
+
+  auto journal_writer::write_batch() -> void
+  {
+    if ( batched_ == 0 )
+      return;
+
+    const auto written{std::fwrite(batch_.data(), 1, batch_.size(), file_)};
+    if ( written != batch_.size() and not error_ )
+      error_ = last_error();
+
+    unsynced_ += batched_;
+    batched_ = 0;
+    batch_.clear();   // keeps the capacity for the next batch
+
+    if ( unsynced_ >= options_.sync_every )
+      sync_file();
+  }
+
+  auto journal_writer::sync_file() -> void
+  {
+    if ( unsynced_ == 0 )
+      return;
+
+    unsynced_ = 0;
+
+#if defined(__linux__)
+    if ( ::fdatasync(::fileno(file_)) != 0 and not error_ )
+      error_ = last_error();
+#elif defined(__unix__) || defined(__APPLE__)
+    if ( ::fsync(::fileno(file_)) != 0 and not error_ )
+      error_ = last_error();
+#endif
+  }
+
+  auto reconcile(journal_contents& journal, const mapped_plan& plan) -> std::size_t
+  {
+    auto listed{std::vector<bool>(plan.size(), false)};
+    auto claimed{claimed_names{}};
+
+    for ( const auto& entry : journal.entries )
+    {
+      const auto index{static_cast<std::size_t>(entry.index)};
+      listed[index] = true;
+      claimed.insert(landed_path(plan.operation(index), entry).string());
+    }
+
+    auto recovered{std::size_t{0}};
+    for ( auto index{std::size_t{0}}; index < plan.size(); ++index )
+    {
+      if ( listed[index] )
+        continue;
+
+      // Without the source's identity (not scanned, or a platform without
+      // inodes) nothing found can be told apart from an unrelated file, so
+      // the operation stays unlisted
+      const auto op{plan.operation(index)};
+      if ( not op.metadata.known or op.metadata.inode == 0
+           or safe_fs::exists(op.source) )
+        continue;
+
+      if ( auto name{find_landed_name(op.destination, op.metadata, claimed)} )
+      {
+        journal.entries.push_back({.index{index}, .final_name{std::move(*name)}});
+        ++recovered;
+      }
+    }
+
+    journal.recovered += recovered;
+    return recovered;
+  }
+
+  auto undo(const journal_contents& journal, const mapped_plan& plan)
+              -> executor::execution_report
+  {
+    auto report{executor::execution_report::start()};
+
+    for ( const auto& entry : journal.entries | vws::reverse )
+    {
+      auto op{plan.operation(static_cast<std::size_t>(entry.index))};
+      auto landed{landed_path(op, entry)};
+
+      const auto moved{already_moved_back(landed, op.source)
+                       ? VoidResult{}
+                       : move_back(landed, op.source)};
+      report = std::move(report).with_processed().finalize();
+
+      if ( moved )
+      {
+        report = std::move(report).with_success().finalize();
+        continue;
+      }
+
+      report = std::move(report)
+                           .with_failure(failed_operation{
+                                .source{std::move(landed)},
+                                .destination{std::move(op.source)},
+                                .error{moved.error()},
+                           })
+                           .finalize();
+    }
+
+    return report;
+  }
+} // namespace fs_ops::journal
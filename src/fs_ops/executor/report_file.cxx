@@ -0,0 +1,243 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs = std::filesystem;
+
+using namespace fs_ops;
+using namespace fs_ops::executor;
+
+namespace
+{
+  constexpr auto report_magic{
+       std::array<char, 8>{'F', 'J', 'R', 'E', 'P', 'O', 'R', 'T'}
+  };
+  constexpr std::uint32_t report_version{1};
+
+  // On-disk sizes and field offsets; independent of any struct layout
+  constexpr std::size_t header_size{40};
+  constexpr std::size_t failure_size{16};
+
+  struct header_field
+  {
+    static constexpr std::size_t version{8};
+    static constexpr std::size_t processed{16};
+    static constexpr std::size_t succeeded{24};
+    static constexpr std::size_t failures{32};
+  };
+
+  struct failure_field
+  {
+    static constexpr std::size_t error{0};
+    static constexpr std::size_t category{4};
+    static constexpr std::size_t source_length{8};
+    static constexpr std::size_t destination_length{12};
+  };
+
+  constexpr std::uint32_t generic_category{0};
+  constexpr std::uint32_t system_category{1};
+
+  constexpr auto little_endian{std::endian::native == std::endian::little};
+
+  auto corrupt_report() -> std::unexpected<std::error_code>
+  {
+    return std::unexpected{std::make_error_code(std::errc::bad_message)};
+  }
+
+  template <typename T>
+  auto read_at(const std::byte* base, const std::size_t offset) noexcept -> T
+  {
+    auto value{T{}};
+    std::memcpy(&value, base + offset, sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  auto put(std::ofstream& out, const T value) -> void
+  {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  auto category_of(const std::error_code ec) -> std::uint32_t
+  {
+    return ec.category() == std::generic_category() ? generic_category
+                                                    : system_category;
+  }
+
+  auto restore_error(const std::int32_t value, const std::uint32_t category)
+              -> std::error_code
+  {
+    return {value,
+            category == generic_category ? std::generic_category()
+                                         : std::system_category()};
+  }
+
+  auto read_bytes(const fs::path& file) -> Result<std::vector<std::byte>>
+  {
+    auto       ec{std::error_code{}};
+    const auto size{fs::file_size(file, ec)};
+    if ( ec )
+      return std::unexpected{ec};
+
+    auto bytes{std::vector<std::byte>(size)};
+    auto in{std::ifstream{file, std::ios::binary}};
+    in.read(
+                reinterpret_cast<char*>(bytes.data()),
+                static_cast<std::streamsize>(size)
+    );
+    if ( not in )
+      return std::unexpected{std::make_error_code(std::errc::io_error)};
+
+    return bytes;
+  }
+
+  auto parse_report(const std::span<const std::byte> bytes)
+              -> Result<execution_report>
+  {
+    const auto* base{bytes.data()};
+    if ( bytes.size() < header_size
+         or std::memcmp(base, report_magic.data(), report_magic.size()) != 0
+         or read_at<std::uint32_t>(base, header_field::version) != report_version )
+      return corrupt_report();
+
+    const auto processed{read_at<std::uint64_t>(base, header_field::processed)};
+    const auto succeeded{read_at<std::uint64_t>(base, header_field::succeeded)};
+    const auto failures{read_at<std::uint64_t>(base, header_field::failures)};
+
+    constexpr auto count_limit{std::uint64_t{std::numeric_limits<int>::max()}};
+    if ( processed > count_limit or succeeded > processed
+         or failures > processed - succeeded )
+      return corrupt_report();
+
+    auto report{execution_report::start()
+                            .with_counts(
+                                        static_cast<int>(processed),
+                                        static_cast<int>(succeeded)
+                            )
+                            .finalize()};
+
+    auto offset{header_size};
+    for ( auto idx{std::uint64_t{0}}; idx < failures; ++idx )
+    {
+      if ( bytes.size() - offset < failure_size )
+        return corrupt_report();
+
+      const auto* record{base + offset};
+      const auto  source_length{std::size_t{
+           read_at<std::uint32_t>(record, failure_field::source_length)
+      }};
+      const auto  destination_length{std::size_t{
+           read_at<std::uint32_t>(record, failure_field::destination_length)
+      }};
+
+      offset += failure_size;
+      if ( bytes.size() - offset < source_length + destination_length )
+        return corrupt_report();
+
+      const auto* text{reinterpret_cast<const char*>(base + offset)};
+      auto        failure{failed_operation{
+           .source{std::string{text, source_length}},
+           .destination{std::string{text + source_length, destination_length}},
+           .error{restore_error(
+                       read_at<std::int32_t>(record, failure_field::error),
+                       read_at<std::uint32_t>(record, failure_field::category)
+           )},
+      }};
+
+      report = std::move(report).with_failure(std::move(failure)).finalize();
+      offset += source_length + destination_length;
+    }
+
+    if ( offset != bytes.size() )
+      return corrupt_report();
+
+    return report;
+  }
+} // namespace
+
+namespace fs_ops::executor
+{
+  auto write_report_file(const execution_report& report, const fs::path& file)
+              -> VoidResult
+  {
+    if constexpr ( not little_endian )
+      return std::unexpected{std::make_error_code(std::errc::not_supported)};
+
+    auto out{std::ofstream{file, std::ios::binary | std::ios::trunc}};
+    if ( not out )
+      return std::unexpected{std::make_error_code(std::errc::io_error)};
+
+    out.write(report_magic.data(), report_magic.size());
+    put<std::uint32_t>(out, report_version);
+    put<std::uint32_t>(out, 0);
+    put<std::uint64_t>(out, static_cast<std::uint64_t>(report.processed_count()));
+    put<std::uint64_t>(out, static_cast<std::uint64_t>(report.success_count()));
+    put<std::uint64_t>(out, static_cast<std::uint64_t>(report.failure_count()));
+
+    for ( const auto& [source, destination, error] : report.failures() )
+    {
+      const auto from{source.string()};
+      const auto to{destination.string()};
+
+      put<std::int32_t>(out, error.value());
+      put<std::uint32_t>(out, category_of(error));
+      put<std::uint32_t>(out, static_cast<std::uint32_t>(from.size()));
+      put<std::uint32_t>(out, static_cast<std::uint32_t>(to.size()));
+      out.write(from.data(), static_cast<std::streamsize>(from.size()));
+      out.write(to.data(), static_cast<std::streamsize>(to.size()));
+    }
+
+    out.flush();
+    return out ? VoidResult{}
+               : std::unexpected{std::make_error_code(std::errc::io_error)};
+  }
+
+  auto read_report_file(const fs::path& file) -> Result<execution_report>
+  {
+    if constexpr ( not little_endian )
+      return std::unexpected{std::make_error_code(std::errc::not_supported)};
+
+    return read_bytes(file).and_then([](const std::vector<std::byte>& bytes) {
+      return parse_report(bytes);
+    });
+  }
+
+  auto merge_report_files(const std::span<const fs::path> files)
+              -> Result<execution_report>
+  {
+    auto merged{execution_report::start()};
+
+    for ( const auto& file : files )
+    {
+      auto report{read_report_file(file)};
+      if ( not report )
+        return std::unexpected{report.error()};
+
+      merged = std::move(merged).with_report(std::move(*report)).finalize();
+    }
+
+    return merged;
+  }
+} // namespace fs_ops::executor
@@ -0,0 +1,84 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <thread>
+#include <utility>
+#include <vector>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs = std::filesystem;
+
+namespace fs_ops::executor::detail
+{
+  auto move_across_devices(const fs::path& from, const fs::path& to) -> VoidResult
+  {
+    return safe_fs::copy_file(from, to).and_then([&from, &to] {
+      auto removed{safe_fs::remove(from)};
+      if ( not removed )
+      {
+        [[maybe_unused]] const auto rolled_back{safe_fs::remove(to)};
+      }
+      return removed;
+    });
+  }
+
+  transfer_pool::transfer_pool(const std::size_t workers, const std::size_t capacity)
+      : queue_{capacity},
+        reports_{std::max<std::size_t>(1, workers)}
+  {
+    workers_.reserve(reports_.size());
+
+    for ( auto slot{std::size_t{0}}; slot < reports_.size(); ++slot )
+    {
+      workers_.emplace_back([this, &report = reports_.slot(slot)] {
+        while ( auto op{queue_.pop()} )
+        {
+          const auto moved{move_across_devices(op->source, op->destination)};
+          if ( moved )
+          {
+            report = std::move(report).with_processed().with_success().finalize();
+            continue;
+          }
+
+          report = std::move(report)
+                               .with_processed()
+                               .with_failure({
+                                    .source{std::move(op->source)},
+                                    .destination{std::move(op->destination)},
+                                    .error{moved.error()},
+                               })
+                               .finalize();
+        }
+      });
+    }
+  }
+
+  transfer_pool::~transfer_pool()
+  {
+    queue_.close();
+  }
+
+  auto transfer_pool::submit(successful_operation&& op) -> void
+  {
+    [[maybe_unused]] const auto queued{queue_.push(std::move(op))};
+  }
+
+  auto transfer_pool::drain() -> execution_report
+  {
+    queue_.close();
+    workers_.clear();   // jthreads join here
+
+    return std::move(reports_).merge();
+  }
+} // namespace fs_ops::executor::detail
@@ -0,0 +1,551 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(FILEJANITOR_HAS_IO_URING)
+#  include <liburing.h>
+#  include <sys/stat.h>
+#endif
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs = std::filesystem;
+
+using namespace fs_ops;
+using namespace fs_ops::executor;
+
+#if defined(FILEJANITOR_HAS_IO_URING)
+namespace
+{
+  // Submission queue size, and so the number of operations per io_uring_enter
+  constexpr unsigned ring_entries{4096};
+  constexpr mode_t   bucket_mode{0755};
+
+  auto errno_code(const int err) -> std::error_code
+  {
+    return {err, std::system_category()};
+  }
+
+  // The ring's mmapped queues are tied to this object, so it is neither
+  // copyable nor movable
+  class uring
+  {
+  public:
+    uring() = default;
+
+    uring(const uring&)                    = delete;
+    auto operator=(const uring&) -> uring& = delete;
+
+    ~uring() { tear_down(); }
+
+    auto init(const unsigned entries) -> VoidResult
+    {
+      const auto rc{io_uring_queue_init(entries, &ring_, 0)};
+      if ( rc < 0 )
+        return std::unexpected{errno_code(-rc)};
+
+      ready_ = true;
+
+      auto* const probe{io_uring_get_probe_ring(&ring_)};
+      if ( probe )
+      {
+        mkdirat_ = io_uring_opcode_supported(probe, IORING_OP_MKDIRAT) != 0;
+        renameat_ = io_uring_opcode_supported(probe, IORING_OP_RENAMEAT) != 0;
+        io_uring_free_probe(probe);
+      }
+      return {};
+    }
+
+    // IORING_OP_RENAMEAT came with Linux 5.11, IORING_OP_MKDIRAT only with 5.15
+    [[nodiscard]] auto has_mkdirat() const noexcept -> bool { return mkdirat_; }
+    [[nodiscard]] auto has_renameat() const noexcept -> bool { return renameat_; }
+
+    // Why the ring was torn down, or EBUSY while it is still up
+    [[nodiscard]] auto failure() const noexcept -> std::error_code
+    {
+      return failed_ ? failed_ : errno_code(EBUSY);
+    }
+
+    // Null once the ring is gone, or if the queue is unexpectedly full
+    auto next_sqe() -> io_uring_sqe*
+    {
+      return ready_ ? io_uring_get_sqe(&ring_) : nullptr;
+    }
+
+    // Submits everything queued with one syscall, then reaps `count` completions.
+    // On any error the completions already posted are still handed out, each
+    // with its own result, and then the ring is torn down, so nothing queued or
+    // in flight can surface in a later batch.
+    template <typename OnCompletion>
+    auto submit_and_reap(const unsigned count, OnCompletion&& on_completion)
+                -> VoidResult
+    {
+      auto rc{io_uring_submit_and_wait(&ring_, count)};
+      while ( rc == -EINTR )
+        rc = io_uring_submit_and_wait(&ring_, count);
+
+      if ( rc < 0 )
+      {
+        drain_posted(on_completion);
+        return fail(-rc);
+      }
+
+      for ( auto reaped{0U}; reaped < count; ++reaped )
+      {
+        io_uring_cqe* cqe{nullptr};
+        auto          wait{io_uring_wait_cqe(&ring_, &cqe)};
+        while ( wait == -EINTR )
+          wait = io_uring_wait_cqe(&ring_, &cqe);
+
+        if ( wait < 0 )
+        {
+          drain_posted(on_completion);
+          return fail(-wait);
+        }
+
+        on_completion(io_uring_cqe_get_data64(cqe), cqe->res);
+        io_uring_cqe_seen(&ring_, cqe);
+      }
+
+      return {};
+    }
+
+  private:
+    // Whatever already completed, without waiting for anything still in flight
+    template <typename OnCompletion>
+    auto drain_posted(OnCompletion& on_completion) -> void
+    {
+      io_uring_cqe* cqe{nullptr};
+      while ( io_uring_peek_cqe(&ring_, &cqe) == 0 and cqe )
+      {
+        on_completion(io_uring_cqe_get_data64(cqe), cqe->res);
+        io_uring_cqe_seen(&ring_, cqe);
+      }
+    }
+
+    auto fail(const int err) -> std::unexpected<std::error_code>
+    {
+      failed_ = errno_code(err);
+      tear_down();
+      return std::unexpected{failed_};
+    }
+
+    // Exiting cancels whatever is still in flight, so no completion can land in
+    // a later batch
+    auto tear_down() -> void
+    {
+      if ( std::exchange(ready_, false) )
+        io_uring_queue_exit(&ring_);
+    }
+
+    io_uring        ring_{};
+    bool            ready_{false};
+    bool            mkdirat_{false};
+    bool            renameat_{false};
+    std::error_code failed_{};
+  };
+
+  // Queues one SQE per item in chunks of ring_entries and hands every CQE result
+  // (0 or -errno) back with its item index. An item is only ever reported from
+  // its own CQE while it has one: those a failed submission never completed
+  // are reported with that submission's error, and so is every item after it,
+  // since the ring is gone by then.
+  template <typename Prepare, typename Complete>
+  auto run_batched(
+              uring&            ring,
+              const std::size_t count,
+              Prepare&&         prepare,
+              Complete&&        complete
+  ) -> void
+  {
+    for ( auto begin{std::size_t{0}}; begin < count; begin += ring_entries )
+    {
+      const auto end{std::min(count, begin + ring_entries)};
+      auto       done{std::vector<bool>(end - begin, false)};
+      auto       queued{0U};
+
+      for ( auto idx{begin}; idx < end; ++idx )
+      {
+        auto* const sqe{ring.next_sqe()};
+        if ( not sqe )
+          break;
+
+        prepare(sqe, idx);
+        io_uring_sqe_set_data64(sqe, idx);
+        ++queued;
+      }
+
+      auto reaped{VoidResult{std::unexpected{ring.failure()}}};
+      if ( queued > 0 )
+      {
+        reaped = ring.submit_and_reap(
+                    queued,
+                    [&](const std::uint64_t idx, const int res) {
+                      if ( idx < begin or idx >= end )
+                        return;   // not one of this chunk's
+
+                      done[idx - begin] = true;
+                      complete(idx, res);
+                    }
+        );
+      }
+
+      // Anything the ring never got to, whether it broke or filled up early
+      const auto error{reaped ? errno_code(EBUSY) : reaped.error()};
+      for ( auto idx{begin}; idx < end; ++idx )
+      {
+        if ( not done[idx - begin] )
+          complete(idx, -error.value());
+      }
+    }
+  }
+
+  struct bucket_dir
+  {
+    fs::path        path;
+    std::string     name;      // relative to parent_fd
+    int             parent_fd{-1};
+    int             fd{-1};
+    std::error_code error{};
+  };
+
+  struct rename_job
+  {
+    std::size_t op_index{};
+    int         source_fd{-1};
+    std::string source_name;
+    int         bucket_fd{-1};
+    std::string target_name;
+  };
+
+  class uring_executor
+  {
+  public:
+    uring_executor(const movement_plan& plan, const bool cross_device)
+        : ops_{plan.operations},
+          cross_device_{cross_device}
+    {}
+
+    auto run(uring& ring) -> execution_report
+    {
+      create_buckets(ring);
+
+      auto jobs{make_jobs()};
+      while ( not jobs.empty() )
+        jobs = rename_round(ring, std::move(jobs));
+
+      copy_across_devices();
+      return std::move(report_).finalize();
+    }
+
+  private:
+    static constexpr auto no_bucket{static_cast<std::size_t>(-1)};
+
+    // Directories are opened once per run and shared by every *at() call. The
+    // batches only carry raw descriptors, so every handle is pinned here for
+    // the whole run, past the context's own bound.
+    auto fd_for(const fs::path& dir) -> Result<int>
+    {
+      auto key{dir.string()};
+      if ( const auto pinned{pinned_.find(key)}; pinned != pinned_.end() )
+        return pinned->second->native();
+
+      return context_.handle_for(dir).transform(
+                  [this, &key](execution_context::directory_ref&& handle) {
+                    const auto fd{handle->native()};
+                    pinned_.emplace(std::move(key), std::move(handle));
+                    return fd;
+                  }
+      );
+    }
+
+    auto record_success() -> void
+    {
+      report_ = std::move(report_).with_processed().with_success().finalize();
+    }
+
+    auto record_failure(const std::size_t op_index, const std::error_code ec) -> void
+    {
+      const auto& op{ops_[op_index]};
+      report_ = std::move(report_)
+                            .with_processed()
+                            .with_failure({
+                                 .source{op.source},
+                                 .destination{op.destination},
+                                 .error{ec}
+                            })
+                            .finalize();
+    }
+
+    // One batched IORING_OP_MKDIRAT per distinct bucket directory; EEXIST is
+    // the common, successful case
+    auto create_buckets(uring& ring) -> void
+    {
+      auto index_of{std::unordered_map<std::string, std::size_t>{}};
+      op_bucket_.assign(ops_.size(), no_bucket);
+
+      for ( auto idx{std::size_t{0}}; idx < ops_.size(); ++idx )
+      {
+        const auto& op{ops_[idx]};
+        if ( op.source == op.destination )
+          continue;
+
+        auto dir{op.destination.parent_path()};
+        const auto [slot, inserted]{
+             index_of.try_emplace(dir.string(), buckets_.size())
+        };
+        if ( inserted )
+        {
+          auto name{dir.filename().string()};
+          buckets_.push_back({.path{std::move(dir)}, .name{std::move(name)}});
+        }
+        op_bucket_[idx] = slot->second;
+      }
+
+      if ( not ring.has_mkdirat() )
+        create_buckets_blocking();
+      else
+        create_buckets_batched(ring);
+
+      for ( auto& bucket : buckets_ )
+      {
+        if ( bucket.error )
+          continue;
+
+        auto handle{fd_for(bucket.path)};
+        bucket.fd    = handle.value_or(-1);
+        bucket.error = handle ? std::error_code{} : handle.error();
+      }
+    }
+
+    // Kernels before 5.15 have no IORING_OP_MKDIRAT
+    auto create_buckets_blocking() -> void
+    {
+      for ( auto& bucket : buckets_ )
+      {
+        const auto created{safe_fs::create_directories(bucket.path)};
+        bucket.error = created ? std::error_code{} : created.error();
+      }
+    }
+
+    auto create_buckets_batched(uring& ring) -> void
+    {
+      for ( auto& bucket : buckets_ )
+      {
+        auto parent{fd_for(bucket.path.parent_path())};
+        bucket.parent_fd = parent.value_or(-1);
+        bucket.error     = parent ? std::error_code{} : parent.error();
+      }
+
+      run_batched(
+                  ring,
+                  buckets_.size(),
+                  [this](io_uring_sqe* sqe, const std::size_t idx) {
+                    const auto& bucket{buckets_[idx]};
+                    if ( bucket.error )
+                    {
+                      io_uring_prep_nop(sqe);
+                      return;
+                    }
+
+                    instrumentation::count(instrumentation::counter::mkdir_calls);
+                    io_uring_prep_mkdirat(
+                                sqe,
+                                bucket.parent_fd,
+                                bucket.name.c_str(),
+                                bucket_mode
+                    );
+                  },
+                  [this](const std::size_t idx, const int res) {
+                    if ( res < 0 and res != -EEXIST and not buckets_[idx].error )
+                      buckets_[idx].error = errno_code(-res);
+                  }
+      );
+    }
+
+    auto make_jobs() -> std::vector<rename_job>
+    {
+      auto jobs{std::vector<rename_job>{}};
+      jobs.reserve(ops_.size());
+
+      for ( auto idx{std::size_t{0}}; idx < ops_.size(); ++idx )
+      {
+        const auto& op{ops_[idx]};
+        if ( op_bucket_[idx] == no_bucket )
+        {
+          report_ = std::move(report_).with_processed().finalize(); // skipped
+          continue;
+        }
+
+        const auto& bucket{buckets_[op_bucket_[idx]]};
+        if ( bucket.error )
+        {
+          record_failure(idx, bucket.error);
+          continue;
+        }
+
+        const auto source{fd_for(op.source.parent_path())};
+        if ( not source )
+        {
+          record_failure(idx, source.error());
+          continue;
+        }
+
+        jobs.push_back({
+             .op_index{idx},
+             .source_fd{*source},
+             .source_name{op.source.filename().string()},
+             .bucket_fd{bucket.fd},
+             .target_name{op.destination.filename().string()}
+        });
+      }
+
+      return jobs;
+    }
+
+    // RENAME_NOREPLACE turns the collision check into the rename itself: only
+    // EEXIST results go through collision resolution and into the next round
+    auto rename_round(uring& ring, std::vector<rename_job>&& jobs)
+                -> std::vector<rename_job>
+    {
+      auto retry{std::vector<rename_job>{}};
+
+      run_batched(
+                  ring,
+                  jobs.size(),
+                  [&jobs](io_uring_sqe* sqe, const std::size_t idx) {
+                    const auto& job{jobs[idx]};
+                    instrumentation::count(instrumentation::counter::rename_calls);
+                    io_uring_prep_renameat(
+                                sqe,
+                                job.source_fd,
+                                job.source_name.c_str(),
+                                job.bucket_fd,
+                                job.target_name.c_str(),
+                                RENAME_NOREPLACE
+                    );
+                  },
+                  [this, &jobs, &retry](const std::size_t idx, const int res) {
+                    complete_rename(std::move(jobs[idx]), res, retry);
+                  }
+      );
+
+      return retry;
+    }
+
+    auto complete_rename(
+                rename_job&&             job,
+                const int                res,
+                std::vector<rename_job>& retry
+    ) -> void
+    {
+      const auto& op{ops_[job.op_index]};
+
+      if ( res == 0 )
+        return record_success();
+
+      if ( res == -EEXIST )
+      {
+        const auto candidate{
+             context_.names_for(op.destination.parent_path())
+                         .claim_candidate(op.destination)
+        };
+
+        if ( not candidate )
+          return record_failure(job.op_index, errno_code(EEXIST));
+
+        job.target_name = candidate->filename().string();
+        retry.push_back(std::move(job));
+        return;
+      }
+
+      // Copied once every rename round is reaped, so no copy holds up the ring
+      if ( res == -EXDEV and cross_device_ )
+      {
+        across_.push_back(job.op_index);
+        return;
+      }
+
+      // Filesystems without RENAME_NOREPLACE (e.g. older NFS) reject the flag;
+      // those operations take a blocking rename that still refuses to replace
+      if ( res == -EINVAL )
+      {
+        const auto target{context_.resolve_collision(op.destination)};
+        const auto moved{safe_fs::rename_no_replace(op.source, target)};
+        return moved ? record_success()
+                     : record_failure(job.op_index, moved.error());
+      }
+
+      record_failure(job.op_index, errno_code(-res));
+    }
+
+    // Blocking copy-then-unlink, as the blocking backend does for EXDEV. The
+    // copy creates its target exclusively, so the name is settled up front.
+    auto copy_across_devices() -> void
+    {
+      for ( const auto op_index : across_ )
+      {
+        const auto& op{ops_[op_index]};
+        const auto  target{context_.resolve_collision(op.destination)};
+        context_.record_arrival(target);
+
+        const auto moved{detail::move_across_devices(op.source, target)};
+        if ( moved )
+          record_success();
+        else
+          record_failure(op_index, moved.error());
+      }
+    }
+
+    using pinned_handles =
+                std::unordered_map<std::string, execution_context::directory_ref>;
+
+    const std::vector<successful_operation>& ops_;
+    bool                                     cross_device_{false};
+    std::vector<std::size_t>                 across_{};
+    execution_report                         report_{execution_report::start()};
+    execution_context                        context_{};
+    pinned_handles                           pinned_{};
+    std::vector<bucket_dir>                  buckets_{};
+    std::vector<std::size_t>                 op_bucket_{};
+  };
+} // namespace
+#endif
+
+namespace fs_ops::executor::detail
+{
+  auto execute_with_io_uring(
+              const movement_plan&     plan,
+              const execution_options& options
+  ) -> execution_report
+  {
+#if defined(FILEJANITOR_HAS_IO_URING)
+    auto ring{uring{}};
+    if ( ring.init(ring_entries) and ring.has_renameat() )
+      return uring_executor{plan, options.cross_device}.run(ring);
+#endif
+    // Built without liburing, or the kernel refused to set up a ring or has no
+    // IORING_OP_RENAMEAT
+    auto blocking{options};
+    blocking.backend = execution_backend::blocking;
+    return execute_plan(plan, blocking);
+  }
+} // namespace fs_ops::executor::detail
@@ -0,0 +1,143 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs = std::filesystem;
+
+using namespace fs_ops;
+using namespace fs_ops::multi_root;
+
+namespace
+{
+  constexpr std::string_view blanks{" \t\r"};
+
+  auto trim(const std::string_view line) -> std::string_view
+  {
+    const auto first{line.find_first_not_of(blanks)};
+    if ( first == std::string_view::npos )
+      return {};
+
+    return line.substr(first, line.find_last_not_of(blanks) - first + 1);
+  }
+
+  auto resolve_worker_count(const std::size_t requested, const std::size_t roots)
+              -> std::size_t
+  {
+    const auto hardware{std::size_t{std::thread::hardware_concurrency()}};
+    const auto wanted{requested != 0 ? requested
+                                     : std::max<std::size_t>(1, hardware)};
+    return std::min(wanted, roots);
+  }
+
+  // One root from scan to report. The arena is declared ahead of the phases,
+  // so it outlives every table they build in it.
+  auto run_root(const fs::path& root, const root_options& options) -> root_result
+  {
+    auto result{root_result{.root{root}}};
+
+    auto ec{std::error_code{}};
+    if ( not fs::is_directory(root, ec) )
+    {
+      result.error = ec ? ec : std::make_error_code(std::errc::not_a_directory);
+      return result;
+    }
+
+    auto arena{arena::run_arena{}};
+    auto scan{options.scan};
+    auto planning{options.planning};
+    auto execution{options.execution};
+
+    scan.memory       = &arena;
+    planning.memory   = &arena;
+    execution.memory  = &arena;
+    execution.journal = nullptr;
+
+    auto [files, errors, metadata]{scanner::collect_files(root, scan)};
+    result.files_scanned = files.size();
+    result.scan_errors   = errors.size();
+
+    if ( files.empty() )
+      return result;
+
+    const auto plan{
+         planner::generate_compact_plan(std::move(files), metadata, root, planning)
+    };
+    result.report = executor::execute_plan(plan, execution);
+    return result;
+  }
+} // namespace
+
+namespace fs_ops::multi_root
+{
+  auto read_manifest(const fs::path& file) -> Result<std::vector<fs::path>>
+  {
+    auto in{std::ifstream{file}};
+    if ( not in )
+      return std::unexpected{
+                   std::make_error_code(std::errc::no_such_file_or_directory)
+      };
+
+    const auto base{file.parent_path()};
+    auto       roots{std::vector<fs::path>{}};
+
+    for ( auto line{std::string{}}; std::getline(in, line); )
+    {
+      const auto entry{trim(line)};
+      if ( entry.empty() or entry.starts_with('#') )
+        continue;
+
+      roots.push_back(base / entry);   // an absolute entry replaces base
+    }
+
+    if ( in.bad() )
+      return std::unexpected{std::make_error_code(std::errc::io_error)};
+
+    return roots;
+  }
+
+  auto run_roots(const std::span<const fs::path> roots, const root_options& options)
+              -> std::vector<root_result>
+  {
+    const auto count{roots.size()};
+
+    auto results{std::vector<root_result>(count)};
+    auto next{std::atomic<std::size_t>{0}};
+    {
+      const auto worker_count{resolve_worker_count(options.worker_count, count)};
+      auto       workers{std::vector<std::jthread>{}};
+      workers.reserve(worker_count);
+
+      // Roots are handed out one at a time, so a slow one never holds up the rest
+      for ( auto worker{std::size_t{0}}; worker < worker_count; ++worker )
+      {
+        workers.emplace_back([&] {
+          for ( auto idx{next.fetch_add(1)}; idx < count; idx = next.fetch_add(1) )
+            results[idx] = run_root(roots[idx], options);
+        });
+      }
+    } // jthreads join here
+
+    return results;
+  }
+} // namespace fs_ops::multi_root
@@ -5,9 +5,6 @@
 module;
 
 // Standard headers in GMF
-#include <filesystem>
-#include <functional>
-#include <optional>
 #include <system_error>
 
 module filejanitor;
@@ -16,34 +13,42 @@ module filejanitor;
 
 namespace fs_ops
 {
-  operation_result::operation_result(const operation_status status)
-      : status_{status}
+  operation_result::operation_result(
+              const operation_status status,
+              const std::error_code  ec
+  ) noexcept
+      : error_{ec},
+        status_{status}
   {}
 
-  auto operation_result::create_success() -> operation_result
+  auto operation_result::create_success() noexcept -> operation_result
   {
     return operation_result{operation_status::success};
   }
 
-  auto operation_result::create_failure(
-              const successful_operation& o,
-              const std::error_code       ec
-  ) -> operation_result
+  auto operation_result::create_failure(const std::error_code ec) noexcept
+              -> operation_result
   {
-    return operation_result{operation_status::failure}.with_failure(o, ec);
+    return operation_result{operation_status::failure, ec};
   }
 
-  auto operation_result::create_skipped() -> operation_result
+  auto operation_result::create_skipped() noexcept -> operation_result
   {
     return operation_result{operation_status::skipped};
   }
-  auto operation_result::status() const -> operation_status { return status_; }
 
-  auto operation_result::failure() const
-              -> std::optional<std::reference_wrapper<const failed_operation>>
+  auto operation_result::create_deferred() noexcept -> operation_result
   {
-    return status_ != operation_status::failure ? std::nullopt
-                                                : std::optional{std::cref(failure_)};
+    return operation_result{operation_status::deferred};
   }
 
+  auto operation_result::status() const noexcept -> operation_status
+  {
+    return status_;
+  }
+
+  auto operation_result::error() const noexcept -> std::error_code
+  {
+    return error_;
+  }
 } // namespace fs_ops
@@ -0,0 +1,137 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs = std::filesystem;
+
+using namespace fs_ops;
+using namespace fs_ops::pipeline;
+
+namespace
+{
+  using path_batch = std::vector<fs::path>;
+
+  struct scan_tally
+  {
+    std::size_t files{0};
+    std::size_t errors{0};
+  };
+
+  auto start_batch(const std::size_t batch_size) -> path_batch
+  {
+    auto batch{path_batch{}};
+    batch.reserve(batch_size);
+    return batch;
+  }
+
+  auto scan_stage(
+              const fs::path&                         root_path,
+              const std::size_t                       batch_size,
+              concurrency::bounded_queue<path_batch>& out,
+              scan_tally&                             tally
+  ) -> void
+  {
+    auto batch{start_batch(batch_size)};
+
+    for ( auto&& result : safe_fs::safe_scan(root_path) )
+    {
+      if ( not result )
+      {
+        ++tally.errors;
+        continue;
+      }
+
+      auto       ec{std::error_code{}};
+      const auto regular{result->is_regular_file(ec)};
+      if ( ec )
+        ++tally.errors;
+
+      if ( not regular )
+        continue;
+
+      batch.push_back(result->path());
+      ++tally.files;
+
+      if ( batch.size() == batch_size )
+        out.push(std::exchange(batch, start_batch(batch_size)));
+    }
+
+    if ( not batch.empty() )
+      out.push(std::move(batch));
+
+    out.close();
+  }
+
+  auto plan_stage(
+              const fs::path&                            root_path,
+              const planner::planning_options&           options,
+              concurrency::bounded_queue<path_batch>&    in,
+              concurrency::bounded_queue<movement_plan>& out
+  ) -> void
+  {
+    while ( auto batch{in.pop()} )
+      out.push(planner::generate_plan(std::move(*batch), root_path, options));
+
+    out.close();
+  }
+
+  auto execute_stage(concurrency::bounded_queue<movement_plan>& in)
+              -> executor::execution_report
+  {
+    auto report{executor::execution_report::start()};
+
+    while ( const auto plan{in.pop()} )
+    {
+      report = std::move(report)
+                           .with_report(executor::execute_plan(*plan))
+                           .finalize();
+    }
+
+    return report;
+  }
+} // namespace
+
+namespace fs_ops::pipeline
+{
+  auto run_pipeline(const fs::path& root_path, const pipeline_options& options)
+              -> pipeline_result
+  {
+    const auto batch_size{std::max<std::size_t>(1, options.batch_size)};
+
+    auto batches{concurrency::bounded_queue<path_batch>{options.queue_depth}};
+    auto plans{concurrency::bounded_queue<movement_plan>{options.queue_depth}};
+    auto tally{scan_tally{}};
+
+    auto report{[&] {
+      const auto scan_thread{std::jthread{[&] {
+        scan_stage(root_path, batch_size, batches, tally);
+      }}};
+      const auto plan_thread{std::jthread{[&] {
+        plan_stage(root_path, options.planning, batches, plans);
+      }}};
+
+      return execute_stage(plans);
+    }()}; // both stages have closed their queues and joined by now
+
+    return {
+         .report{std::move(report)},
+         .files_scanned{tally.files},
+         .scan_errors{tally.errors}
+    };
+  }
+} // namespace fs_ops::pipeline
@@ -0,0 +1,98 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs = std::filesystem;
+
+namespace
+{
+  using word = std::uint64_t;
+
+  constexpr auto word_size{sizeof(word)};
+  constexpr auto lanes{word{0x0101010101010101}};
+  constexpr auto high_bits{word{0x8080808080808080}};
+  constexpr auto low_bits{word{0x7F7F7F7F7F7F7F7F}};
+
+  // SWAR lowercase of eight bytes. Adding 0x80 - 'A' sets a lane's high bit iff
+  // its low seven bits are >= 'A'; adding 0x7F - 'Z' iff they are > 'Z'. Lanes
+  // that already had their high bit set are not ASCII and are excluded. No lane
+  // can carry into its neighbour since the low seven bits never exceed 0x7F.
+  constexpr auto lowercase_word(const word bytes) noexcept -> word
+  {
+    const auto low{bytes & low_bits};
+    const auto at_least_a{low + (0x80 - word{'A'}) * lanes};
+    const auto above_z{low + (0x7F - word{'Z'}) * lanes};
+    const auto upper{at_least_a & ~above_z & ~bytes & high_bits};
+
+    return bytes | (upper >> 2); // 0x80 >> 2 == 0x20, the ASCII case bit
+  }
+
+  constexpr auto lowercase_byte(const char c) noexcept -> char
+  {
+    return c >= 'A' and c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+  }
+
+  static_assert(lowercase_word(0x5A41'5A41'5A41'5A41) == 0x7A61'7A61'7A61'7A61);
+  static_assert(lowercase_word(0x405B'C15A'E22E'7A61) == 0x405B'C17A'E22E'7A61);
+} // namespace
+
+namespace fs_ops::planner
+{
+  auto extension_of(const std::string_view path) noexcept -> std::string_view
+  {
+    const auto slash{path.find_last_of('/')};
+    const auto name{slash == std::string_view::npos ? path : path.substr(slash + 1)};
+
+    if ( name == "." or name == ".." )
+      return {};
+
+    const auto dot{name.rfind('.')};
+    return dot == std::string_view::npos or dot == 0 ? std::string_view{}
+                                                     : name.substr(dot);
+  }
+
+  auto ascii_lowercase(const std::string_view text, char* out) noexcept -> void
+  {
+    auto offset{std::size_t{0}};
+
+    for ( ; offset + word_size <= text.size(); offset += word_size )
+    {
+      auto bytes{word{}};
+      std::memcpy(&bytes, text.data() + offset, word_size);
+      bytes = lowercase_word(bytes);
+      std::memcpy(out + offset, &bytes, word_size);
+    }
+
+    for ( ; offset < text.size(); ++offset )
+      out[offset] = lowercase_byte(text[offset]);
+  }
+
+  auto normalize_extension(const fs::path& path) -> std::string
+  {
+#if defined(_WIN32)
+    // Native Windows paths are wide, so they are narrowed first (allocating)
+    const auto text{path.generic_string()};
+#else
+    const auto& text{path.native()};
+#endif
+
+    const auto ext{extension_of(text)};
+    auto       lowered{std::string(ext.size(), '\0')};
+    ascii_lowercase(ext, lowered.data());
+    return lowered;
+  }
+} // namespace fs_ops::planner
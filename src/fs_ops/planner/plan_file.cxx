@@ -0,0 +1,493 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs  = std::filesystem;
+namespace rng = std::ranges;
+
+namespace
+{
+  constexpr auto plan_magic{std::array<char, 8>{'F', 'J', 'P', 'L', 'A', 'N', 0, 0}};
+  constexpr std::uint32_t plan_version{2};
+
+  // On-disk sizes and field offsets; independent of any struct layout
+  constexpr std::size_t header_size{40};
+  constexpr std::size_t slice_size{16};
+  constexpr std::size_t record_size{56};
+
+  struct header_field
+  {
+    static constexpr std::size_t version{8};
+    static constexpr std::size_t bucket_count{12};
+    static constexpr std::size_t source_dir_count{16};
+    static constexpr std::size_t root_length{20};
+    static constexpr std::size_t op_count{24};
+    static constexpr std::size_t arena_size{32};
+  };
+
+  struct record_field
+  {
+    static constexpr std::size_t name_offset{0};
+    static constexpr std::size_t name_length{8};
+    static constexpr std::size_t source_dir{12};
+    static constexpr std::size_t bucket{16};
+    static constexpr std::size_t flags{20};
+    static constexpr std::size_t device{24};
+    static constexpr std::size_t inode{32};
+    static constexpr std::size_t size{40};
+    static constexpr std::size_t mtime_ns{48};
+  };
+
+  // Record flags: what the scan learned of the source, if it was asked
+  struct record_flag
+  {
+    static constexpr std::uint32_t known{1U << 0U};
+    static constexpr std::uint32_t symlink{1U << 1U};
+  };
+
+  auto flags_of(const fs_ops::file_metadata& metadata) noexcept -> std::uint32_t
+  {
+    return (metadata.known ? record_flag::known : 0U)
+           | (metadata.symlink ? record_flag::symlink : 0U);
+  }
+
+  constexpr auto little_endian{std::endian::native == std::endian::little};
+
+  auto corrupt_plan() -> std::unexpected<std::error_code>
+  {
+    return std::unexpected{std::make_error_code(std::errc::bad_message)};
+  }
+
+  template <typename T>
+  auto read_at(const std::byte* base, const std::size_t offset) noexcept -> T
+  {
+    auto value{T{}};
+    std::memcpy(&value, base + offset, sizeof(T));
+    return value;
+  }
+
+  // Appends fixed-width fields to a plan file section
+  template <typename T>
+  auto put(std::ofstream& out, const T value) -> void
+  {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  auto put_slice(
+              std::ofstream&      out,
+              const std::uint64_t offset,
+              const std::size_t   length
+  ) -> void
+  {
+    put<std::uint64_t>(out, offset);
+    put<std::uint64_t>(out, length);
+  }
+
+  // offset + length <= limit, without overflowing on corrupt input
+  auto fits(
+              const std::uint64_t offset,
+              const std::uint64_t length,
+              const std::uint64_t limit
+  ) -> bool
+  {
+    return offset <= limit and length <= limit - offset;
+  }
+
+  // A bucket or file name joins a path as exactly one component; anything
+  // else would move a file outside its bucket or the root
+  auto plain_name(const std::string_view name) -> bool
+  {
+    return not name.empty() and name != "." and name != ".."
+           and name.find_first_of(std::string_view{"/\0", 2}) == name.npos;
+  }
+
+  // Header, tables, records, then the arena, in the order open() reads them
+  auto write_sections(const fs_ops::compact_plan& plan, std::ofstream& out) -> void
+  {
+    const auto root{plan.root().string()};
+    const auto dirs{
+         std::views::iota(std::size_t{0}, plan.source_dir_count())
+         | std::views::transform([&plan](const std::size_t dir) {
+             return plan.source_dir(static_cast<std::uint32_t>(dir)).string();
+           })
+         | rng::to<std::vector>()
+    };
+
+    // The arena is root, then bucket names, then source dirs, then filenames
+    auto arena_size{std::uint64_t{root.size()}};
+    for ( auto bucket{std::uint32_t{0}}; bucket < plan.bucket_count(); ++bucket )
+      arena_size += plan.bucket_name(bucket).size();
+    for ( const auto& dir : dirs )
+      arena_size += dir.size();
+    const auto names_base{arena_size};
+    arena_size += plan.name_arena().size();
+
+    out.write(plan_magic.data(), plan_magic.size());
+    put<std::uint32_t>(out, plan_version);
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(plan.bucket_count()));
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(dirs.size()));
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(root.size()));
+    put<std::uint64_t>(out, plan.size());
+    put<std::uint64_t>(out, arena_size);
+
+    auto cursor{std::uint64_t{root.size()}};
+    for ( auto bucket{std::uint32_t{0}}; bucket < plan.bucket_count(); ++bucket )
+    {
+      const auto length{plan.bucket_name(bucket).size()};
+      put_slice(out, cursor, length);
+      cursor += length;
+    }
+    for ( const auto& dir : dirs )
+    {
+      put_slice(out, cursor, dir.size());
+      cursor += dir.size();
+    }
+
+    for ( auto idx{std::size_t{0}}; idx < plan.size(); ++idx )
+    {
+      const auto& op{plan.record(idx)};
+      put<std::uint64_t>(out, names_base + op.name_offset);
+      put<std::uint32_t>(out, op.name_length);
+      put<std::uint32_t>(out, op.source_dir);
+      put<std::uint32_t>(out, op.bucket);
+
+      const auto metadata{plan.metadata(idx)};
+      put<std::uint32_t>(out, flags_of(metadata));
+      put<std::uint64_t>(out, metadata.device);
+      put<std::uint64_t>(out, metadata.inode);
+      put<std::uint64_t>(out, metadata.size);
+      put<std::int64_t>(out, metadata.mtime_ns);
+    }
+
+    out.write(root.data(), static_cast<std::streamsize>(root.size()));
+    for ( auto bucket{std::uint32_t{0}}; bucket < plan.bucket_count(); ++bucket )
+    {
+      const auto& name{plan.bucket_name(bucket)};
+      out.write(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+    for ( const auto& dir : dirs )
+      out.write(dir.data(), static_cast<std::streamsize>(dir.size()));
+
+    const auto names{plan.name_arena()};
+    out.write(names.data(), static_cast<std::streamsize>(names.size()));
+  }
+} // namespace
+
+namespace fs_ops
+{
+  auto write_plan_file(const compact_plan& plan, const fs::path& file) -> VoidResult
+  {
+    if constexpr ( not little_endian )
+      return std::unexpected{std::make_error_code(std::errc::not_supported)};
+
+    auto temporary{file};
+    temporary += ".tmp";
+
+    {
+      auto out{std::ofstream{temporary, std::ios::binary | std::ios::trunc}};
+      if ( not out )
+        return std::unexpected{std::make_error_code(std::errc::io_error)};
+
+      write_sections(plan, out);
+
+      out.flush();
+      if ( not out )
+        return std::unexpected{std::make_error_code(std::errc::io_error)};
+    }
+
+    // Renamed only once its data is on disk, so a crash (or a resume reading
+    // it meanwhile) sees either the whole old plan or the whole new one
+    return safe_fs::sync_file(temporary).and_then([&temporary, &file] {
+      return safe_fs::rename(temporary, file);
+    });
+  }
+
+  mapped_plan::mapped_plan(mapped_plan&& other) noexcept
+      : data_{std::exchange(other.data_, nullptr)}
+      , length_{std::exchange(other.length_, 0)}
+      , owned_{std::move(other.owned_)}
+      , op_count_{other.op_count_}
+      , bucket_count_{other.bucket_count_}
+      , source_dir_count_{other.source_dir_count_}
+      , buckets_at_{other.buckets_at_}
+      , source_dirs_at_{other.source_dirs_at_}
+      , records_at_{other.records_at_}
+      , arena_at_{other.arena_at_}
+      , arena_size_{other.arena_size_}
+      , root_{other.root_}
+  {}
+
+  auto mapped_plan::operator=(mapped_plan&& other) noexcept -> mapped_plan&
+  {
+    std::swap(data_, other.data_);
+    std::swap(length_, other.length_);
+    std::swap(owned_, other.owned_);
+    std::swap(op_count_, other.op_count_);
+    std::swap(bucket_count_, other.bucket_count_);
+    std::swap(source_dir_count_, other.source_dir_count_);
+    std::swap(buckets_at_, other.buckets_at_);
+    std::swap(source_dirs_at_, other.source_dirs_at_);
+    std::swap(records_at_, other.records_at_);
+    std::swap(arena_at_, other.arena_at_);
+    std::swap(arena_size_, other.arena_size_);
+    std::swap(root_, other.root_);
+    return *this;
+  }
+
+  mapped_plan::~mapped_plan()
+  {
+#if defined(__unix__) || defined(__APPLE__)
+    if ( data_ != nullptr and owned_.empty() )
+      ::munmap(const_cast<std::byte*>(data_), length_);
+#endif
+  }
+
+  auto mapped_plan::open(const fs::path& file) -> Result<mapped_plan>
+  {
+    if constexpr ( not little_endian )
+      return std::unexpected{std::make_error_code(std::errc::not_supported)};
+
+    auto plan{mapped_plan{}};
+
+#if defined(__unix__) || defined(__APPLE__)
+    const auto fd{::open(file.c_str(), O_RDONLY | O_CLOEXEC)};
+    if ( fd < 0 )
+      return std::unexpected{std::error_code{errno, std::system_category()}};
+
+    struct stat info{};
+    if ( ::fstat(fd, &info) != 0 or info.st_size < off_t{header_size} )
+    {
+      ::close(fd);
+      return corrupt_plan();
+    }
+
+    const auto length{static_cast<std::size_t>(info.st_size)};
+    auto*      mapping{::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0)};
+    ::close(fd); // the mapping keeps the file alive
+
+    if ( mapping == MAP_FAILED )
+      return std::unexpected{std::error_code{errno, std::system_category()}};
+
+    plan.data_   = static_cast<const std::byte*>(mapping);
+    plan.length_ = length;
+#else
+    auto in{std::ifstream{file, std::ios::binary | std::ios::ate}};
+    if ( not in )
+      return std::unexpected{std::make_error_code(std::errc::io_error)};
+
+    plan.owned_.resize(static_cast<std::size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(plan.owned_.data()),
+            static_cast<std::streamsize>(plan.owned_.size()));
+    if ( not in or plan.owned_.size() < header_size )
+      return corrupt_plan();
+
+    plan.data_   = plan.owned_.data();
+    plan.length_ = plan.owned_.size();
+#endif
+
+    return plan.validate() ? Result<mapped_plan>{std::move(plan)} : corrupt_plan();
+  }
+
+  // Reads the header, then does the only O(n) step of open(): every slice and
+  // record is bounds-checked once so accessors can index without further checks
+  auto mapped_plan::validate() -> bool
+  {
+    if ( std::memcmp(data_, plan_magic.data(), plan_magic.size()) != 0
+         or read_at<std::uint32_t>(data_, header_field::version) != plan_version )
+      return false;
+
+    const auto ops{read_at<std::uint64_t>(data_, header_field::op_count)};
+    if ( ops > length_ / record_size )
+      return false;
+
+    using field = header_field;
+
+    op_count_         = ops;
+    bucket_count_     = read_at<std::uint32_t>(data_, field::bucket_count);
+    source_dir_count_ = read_at<std::uint32_t>(data_, field::source_dir_count);
+    arena_size_       = read_at<std::uint64_t>(data_, field::arena_size);
+    buckets_at_       = header_size;
+    source_dirs_at_   = buckets_at_ + bucket_count_ * slice_size;
+    records_at_       = source_dirs_at_ + source_dir_count_ * slice_size;
+    arena_at_         = records_at_ + op_count_ * record_size;
+    root_             = {
+                     .offset{0},
+                     .length{read_at<std::uint32_t>(data_, field::root_length)}
+    };
+
+    if ( not fits(arena_at_, arena_size_, length_)
+         or not fits(root_.offset, root_.length, arena_size_) )
+      return false;
+
+    // Bucket names must also be plain names; source dirs are whole paths
+    auto slice_ok{[this](
+                            const std::size_t table,
+                            const std::size_t count,
+                            const bool        names
+                  ) {
+      const auto indices{std::views::iota(std::size_t{0}, count)};
+      return rng::all_of(indices, [this, table, names](const std::size_t idx) {
+        const auto s{slice_at(table, idx)};
+        return fits(s.offset, s.length, arena_size_)
+               and (not names or plain_name(text(s)));
+      });
+    }};
+
+    auto record_ok{[this](const std::size_t idx) {
+      const auto r{record_at(idx)};
+      return fits(r.name_offset, r.name_length, arena_size_)
+             and plain_name(text({.offset{r.name_offset}, .length{r.name_length}}))
+             and r.source_dir < source_dir_count_ and r.bucket < bucket_count_;
+    }};
+
+    return slice_ok(buckets_at_, bucket_count_, true)
+           and slice_ok(source_dirs_at_, source_dir_count_, false)
+           and rng::all_of(std::views::iota(std::size_t{0}, op_count_), record_ok);
+  }
+
+  auto mapped_plan::slice_at(
+              const std::size_t table_offset,
+              const std::size_t index
+  ) const -> slice
+  {
+    const auto at{table_offset + index * slice_size};
+    return {
+         .offset{read_at<std::uint64_t>(data_, at)},
+         .length{read_at<std::uint64_t>(data_, at + 8)}
+    };
+  }
+
+  auto mapped_plan::record_at(const std::size_t index) const -> record
+  {
+    const auto at{records_at_ + index * record_size};
+    return {
+         .name_offset{read_at<std::uint64_t>(data_, at + record_field::name_offset)},
+         .name_length{read_at<std::uint32_t>(data_, at + record_field::name_length)},
+         .source_dir{read_at<std::uint32_t>(data_, at + record_field::source_dir)},
+         .bucket{read_at<std::uint32_t>(data_, at + record_field::bucket)}
+    };
+  }
+
+  auto mapped_plan::text(const slice s) const -> std::string_view
+  {
+    return {reinterpret_cast<const char*>(data_ + arena_at_ + s.offset), s.length};
+  }
+
+  auto mapped_plan::size() const noexcept -> std::size_t { return op_count_; }
+
+  auto mapped_plan::empty() const noexcept -> bool { return op_count_ == 0; }
+
+  auto mapped_plan::root() const -> std::string_view { return text(root_); }
+
+  auto mapped_plan::bucket_count() const noexcept -> std::size_t
+  {
+    return bucket_count_;
+  }
+
+  auto mapped_plan::bucket_name(const std::uint32_t bucket) const -> std::string_view
+  {
+    return text(slice_at(buckets_at_, bucket));
+  }
+
+  auto mapped_plan::source_dir(const std::uint32_t dir) const -> std::string_view
+  {
+    return text(slice_at(source_dirs_at_, dir));
+  }
+
+  auto mapped_plan::bucket_of(const std::size_t index) const -> std::uint32_t
+  {
+    return record_at(index).bucket;
+  }
+
+  auto mapped_plan::metadata(const std::size_t index) const -> file_metadata
+  {
+    const auto at{records_at_ + index * record_size};
+    const auto flags{read_at<std::uint32_t>(data_, at + record_field::flags)};
+    if ( (flags & record_flag::known) == 0 )
+      return {};
+
+    return {
+         .device{read_at<std::uint64_t>(data_, at + record_field::device)},
+         .inode{read_at<std::uint64_t>(data_, at + record_field::inode)},
+         .size{read_at<std::uint64_t>(data_, at + record_field::size)},
+         .mtime_ns{read_at<std::int64_t>(data_, at + record_field::mtime_ns)},
+         .symlink{(flags & record_flag::symlink) != 0},
+         .known{true},
+    };
+  }
+
+  auto mapped_plan::filename(const std::size_t index) const -> std::string_view
+  {
+    const auto r{record_at(index)};
+    return text({.offset{r.name_offset}, .length{r.name_length}});
+  }
+
+  auto mapped_plan::source(const std::size_t index) const -> fs::path
+  {
+    return fs::path{source_dir(record_at(index).source_dir)} / filename(index);
+  }
+
+  auto mapped_plan::destination(const std::size_t index) const -> fs::path
+  {
+    return fs::path{root()} / bucket_name(bucket_of(index)) / filename(index);
+  }
+
+  auto mapped_plan::is_in_place(const std::size_t index) const -> bool
+  {
+    const auto r{record_at(index)};
+    const auto dir{source_dir(r.source_dir)};
+    const auto root_path{root()};
+    const auto bucket{bucket_name(r.bucket)};
+    const auto separator{root_path.ends_with('/') ? 0UZ : 1UZ};
+
+    return dir.size() == root_path.size() + separator + bucket.size()
+           and dir.starts_with(root_path) and dir.ends_with(bucket)
+           and (separator == 0 or dir[root_path.size()] == '/');
+  }
+
+  auto mapped_plan::operation(const std::size_t index) const -> successful_operation
+  {
+    return {
+         .source{source(index)},
+         .destination{destination(index)},
+         .bucket_name{std::string{bucket_name(bucket_of(index))}},
+         .metadata{metadata(index)}
+    };
+  }
+
+  auto mapped_plan::to_movement_plan() const -> movement_plan
+  {
+    return {operations() | rng::to<std::vector>()};
+  }
+} // namespace fs_ops
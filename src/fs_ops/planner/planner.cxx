@@ -6,10 +6,19 @@ module;
 
 // Standard headers in GMF
 #include <algorithm>
-#include <cctype>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
+#include <map>
+#include <memory_resource>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 module filejanitor;
@@ -22,34 +31,80 @@ using namespace fs_ops;
 
 namespace
 {
-  auto normalize_extension(const fs::path& path) -> std::string
-  {
-    return not path.has_extension()
-                       ? std::string{}
-                       : path.extension().string()
-                                     | vws::transform([](const unsigned char c) {
-                                         return std::tolower(c);
-                                       })
-                                     | rng::to<std::string>();
-  }
+  // The planner's own tables, all dropped once the plan is built, so they can
+  // come out of a per-run arena
+  using file_list = std::pmr::vector<scanned_file>;
 
-  auto decorate_with_extensions(std::vector<fs::path> raw_files)
-              -> std::vector<scanned_file>
+  // Moves the paths out of raw_files, pairing each with its metadata when there
+  // is any. Sized up front: a vector regrown inside a monotonic arena would
+  // leave every outgrown buffer behind.
+  auto decorate_with_extensions(
+              const std::span<fs::path>            raw_files,
+              const std::span<const file_metadata> metadata,
+              std::pmr::memory_resource* const     memory
+  ) -> file_list
   {
-    return std::move(raw_files)
-           | vws::transform([](const fs::path& p) {
-               return scanned_file{.path{p}, .extension{normalize_extension(p)}};
-             })
-           | rng::to<std::vector>();
+    auto decorated{file_list{memory}};
+    decorated.reserve(raw_files.size());
+
+    for ( auto idx{std::size_t{0}}; idx < raw_files.size(); ++idx )
+    {
+      auto& path{raw_files[idx]};
+      auto  extension{planner::normalize_extension(path)};
+      decorated.push_back({
+           .path{std::move(path)},
+           .extension{std::move(extension)},
+           .metadata{metadata.empty() ? file_metadata{} : metadata[idx]},
+      });
+    }
+
+    return decorated;
   }
 
-  auto sort_by_extension(std::vector<scanned_file>&& raw_files)
-              -> std::vector<scanned_file>
+  // Groups files by extension in O(n): one hash lookup per file assigns its
+  // extension a group id, only the distinct extensions (a few hundred at
+  // most) are sorted, and a stable counting scatter lays the groups out in
+  // that key order. Files keep their input order within a group.
+  auto group_by_extension(file_list&& files) -> file_list
   {
-    return [to_sort = std::move(raw_files)] mutable {
-      rng::sort(to_sort, {}, &scanned_file::extension);
-      return to_sort;
-    }();
+    using index_list = std::pmr::vector<std::size_t>;
+
+    const auto memory{files.get_allocator().resource()};
+    auto       group_of{index_list(files.size(), memory)};
+    auto       keys{std::pmr::vector<std::string_view>{memory}};
+    auto       id_of{std::pmr::unordered_map<std::string_view, std::size_t>{memory}};
+
+    for ( auto idx{std::size_t{0}}; idx < files.size(); ++idx )
+    {
+      const auto [slot, inserted]{
+           id_of.try_emplace(files[idx].extension, keys.size())
+      };
+
+      if ( inserted )
+        keys.push_back(files[idx].extension);
+
+      group_of[idx] = slot->second;
+    }
+
+    auto key_order{
+         vws::iota(std::size_t{0}, keys.size()) | rng::to<index_list>(memory)
+    };
+    rng::sort(key_order, {}, [&keys](const std::size_t id) { return keys[id]; });
+
+    auto next_slot{index_list(keys.size(), memory)};
+    for ( const auto id : group_of )
+      ++next_slot[id];
+
+    // Turn per-group counts into each group's first slot, in key order
+    auto running{std::size_t{0}};
+    for ( const auto id : key_order )
+      running += std::exchange(next_slot[id], running);
+
+    auto grouped{file_list(files.size(), memory)};
+    for ( auto idx{std::size_t{0}}; idx < files.size(); ++idx )
+      grouped[next_slot[group_of[idx]]++] = std::move(files[idx]);
+
+    return grouped;
   }
 
   auto make_bucket(const scanned_file& file) -> std::string
@@ -57,52 +112,292 @@ namespace
     return file.extension.empty() ? "no_extension" : file.extension.substr(1);
   }
 
-  auto generate(const std::vector<scanned_file>& sorted, const fs::path& r_path)
-              -> movement_plan
+#if defined(_WIN32)
+  // Native Windows paths are wide, so the name is narrowed first (allocating)
+  auto filename_of(const fs::path& path) -> std::string
+  {
+    return path.filename().string();
+  }
+#else
+  auto filename_of(const fs::path& path) -> std::string_view
+  {
+    const auto& text{path.native()};
+    return std::string_view{text}.substr(text.find_last_of('/') + 1);
+  }
+#endif
+
+  // Adds files to a plan run by run, bucketing them by extension or through a
+  // rule set. Rule buckets are interned on first use, so rules no file matched
+  // leave no empty bucket behind.
+  class bucket_resolver
+  {
+  public:
+    bucket_resolver(compact_plan& plan, const rules::rule_set* const rule_set)
+        : plan_{plan},
+          rules_{rule_set},
+          rule_ids_(rule_set ? rule_set->bucket_count() : 0, rules::no_match)
+    {}
+
+    bucket_resolver(const bucket_resolver&)                    = delete;
+    auto operator=(const bucket_resolver&) -> bucket_resolver& = delete;
+
+    // files is one extension run, first its first file. Extension rules give
+    // the whole run one bucket, found once; only prefix and size rules are
+    // checked per file, through the matcher specialized for the shapes in use.
+    template <typename Files>
+    auto add_run(const scanned_file& first, Files&& files) -> void
+    {
+      const auto by_extension{rules_ ? rules_->match_extension(first.extension)
+                                     : rules::no_match};
+      const auto run_bucket{by_extension != rules::no_match
+                            ? rule_bucket(by_extension)
+                            : plan_.intern_bucket(make_bucket(first))};
+
+      const auto prefix{rules_ and rules_->has_prefix_rules()};
+      const auto size{rules_ and rules_->has_size_rules()};
+
+      if ( prefix and size )
+        add_files<true, true>(files, run_bucket);
+      else if ( prefix )
+        add_files<true, false>(files, run_bucket);
+      else if ( size )
+        add_files<false, true>(files, run_bucket);
+      else
+      {
+        for ( const auto& file : files )
+          plan_.add(file.path, run_bucket, file.metadata);
+      }
+    }
+
+  private:
+    template <bool Prefix, bool Size, typename Files>
+    auto add_files(Files&& files, const std::uint32_t run_bucket) -> void
+    {
+      for ( const auto& file : files )
+      {
+        const auto name{filename_of(file.path)};
+        auto       facts{rules::file_facts{.name{name}, .extension{file.extension}}};
+        auto       matched{rules::no_match};
+
+        // A file that cannot be stat'ed is classified as if no size rule existed
+        if constexpr ( Size )
+        {
+          if ( const auto size{size_of(file)}; size )
+          {
+            facts.size = *size;
+            matched    = rules_->classify<Prefix, true>(facts);
+          }
+          else
+            matched = rules_->classify<Prefix, false>(facts);
+        }
+        else
+          matched = rules_->classify<Prefix, false>(facts);
+
+        plan_.add(
+                    file.path,
+                    matched == rules::no_match ? run_bucket : rule_bucket(matched),
+                    file.metadata
+        );
+      }
+    }
+
+    // From the scan when it brought metadata, else one stat
+    static auto size_of(const scanned_file& file) -> std::optional<std::uint64_t>
+    {
+      if ( file.metadata.known )
+        return file.metadata.size;
+
+      const auto stamp{safe_fs::stamp(file.path)};
+      return stamp ? std::optional{stamp->size} : std::nullopt;
+    }
+
+    auto rule_bucket(const std::uint32_t rule) -> std::uint32_t
+    {
+      auto& id{rule_ids_[rule]};
+      if ( id == rules::no_match )
+        id = plan_.intern_bucket(rules_->bucket_name(rule));
+      return id;
+    }
+
+    compact_plan&              plan_;
+    const rules::rule_set*     rules_;
+    std::vector<std::uint32_t> rule_ids_;
+  };
+
+  // Consumes the grouped list: it is the last stage to see it
+  auto generate(
+              file_list&&                  grouped,
+              const fs::path&              r_path,
+              const rules::rule_set* const rule_set
+  ) -> compact_plan
   {
     auto compare_extensions{[](const auto& a, const auto& b) {
       return a.extension == b.extension;
     }};
 
-    auto empty_chunks{[](const auto& chunk) { return not chunk.empty(); }};
-
-    auto make_move_plans{[&r_path](const auto& chunk) {
-      return chunk
-             | vws::transform([&r_path, b_name{make_bucket(chunk.front())}](
-                                          const auto& file
-                              ) {
-                 return successful_operation{
-                      .source{file.path},
-                      .destination{r_path / b_name / file.path.filename()},
-                      .bucket_name{b_name}
-                 };
-               })
-             | rng::to<std::vector<successful_operation>>();
+    auto plan{compact_plan{r_path}};
+    plan.reserve(grouped.size());
+
+    auto resolver{bucket_resolver{plan, rule_set}};
+    for ( auto&& chunk : grouped | vws::chunk_by(compare_extensions) )
+      resolver.add_run(chunk.front(), chunk);
+
+    return plan;
+  }
+
+  // Below this many files per extra thread, spawning it costs more than it saves
+  constexpr std::size_t min_files_per_worker{16'384};
+
+  auto resolve_worker_count(const std::size_t requested, const std::size_t files)
+              -> std::size_t
+  {
+    const auto hardware{std::size_t{std::thread::hardware_concurrency()}};
+    const auto wanted{
+         requested != 0 ? requested : std::max<std::size_t>(1, hardware)
+    };
+    return std::clamp<std::size_t>(files / min_files_per_worker, 1, wanted);
+  }
+
+  // Every shard is a contiguous slice of the input, decorated and grouped on
+  // its own thread. Shards come back in input order, each built in memory, so
+  // handing a finished shard over to its slot is a pointer move.
+  auto group_shards(
+              std::vector<fs::path>&               raw_files,
+              const std::span<const file_metadata> metadata,
+              const std::size_t                    workers,
+              std::pmr::memory_resource* const     memory
+  ) -> std::pmr::vector<file_list>
+  {
+    const auto shard_size{(raw_files.size() + workers - 1) / workers};
+    auto       shards{std::pmr::vector<file_list>(workers, memory)};
+
+    {
+      auto pool{std::vector<std::jthread>{}};
+      pool.reserve(workers);
+
+      for ( auto worker{std::size_t{0}}; worker < workers; ++worker )
+      {
+        const auto first{std::min(raw_files.size(), worker * shard_size)};
+        const auto count{std::min(raw_files.size() - first, shard_size)};
+        const auto slice{std::span{raw_files}.subspan(first, count)};
+        const auto facts{
+             metadata.empty() ? metadata : metadata.subspan(first, count)
+        };
+
+        pool.emplace_back([&shard{shards[worker]}, slice, facts, memory] {
+          shard = group_by_extension(decorate_with_extensions(slice, facts, memory));
+        });
+      }
+    } // jthreads join here
+
+    return shards;
+  }
+
+  // Each shard is already in extension order with files in input order, so
+  // taking every extension's runs shard by shard puts each file exactly where
+  // the serial grouping would have
+  auto generate_merged(
+              const std::pmr::vector<file_list>& shards,
+              const fs::path&                    r_path,
+              const rules::rule_set* const       rule_set
+  ) -> compact_plan
+  {
+    using run = std::span<const scanned_file>;
+
+    const auto memory{shards.get_allocator().resource()};
+
+    auto compare_extensions{[](const auto& a, const auto& b) {
+      return a.extension == b.extension;
     }};
 
-    return {
-         sorted
-         | vws::chunk_by(compare_extensions)
-         | vws::filter(empty_chunks)
-         | vws::transform(make_move_plans)
-         | vws::join
-         | rng::to<std::vector>()
+    auto runs_by_extension{
+         std::pmr::map<std::string_view, std::pmr::vector<run>>{memory}
     };
+    auto total{std::size_t{0}};
+
+    for ( const auto& shard : shards )
+    {
+      total += shard.size();
+      for ( auto&& chunk : shard | vws::chunk_by(compare_extensions) )
+        runs_by_extension[chunk.front().extension].emplace_back(chunk);
+    }
+
+    auto plan{compact_plan{r_path}};
+    plan.reserve(total);
+
+    auto resolver{bucket_resolver{plan, rule_set}};
+    for ( const auto& runs : runs_by_extension | vws::values )
+      resolver.add_run(runs.front().front(), runs | vws::join);
+
+    return plan;
   }
 } // namespace
 
 namespace fs_ops::planner
 {
   // TODO: Can be given a fluent interface or a monadic style
-  auto generate_plan(std::vector<fs::path>&& raw_files, const fs::path& root_path)
-              -> movement_plan
+  auto generate_compact_plan(
+              std::vector<fs::path>&& raw_files,
+              const fs::path&         root_path
+  ) -> compact_plan
   {
     // 1. Decorate the raw files with extensions
-    // 2. Sort the decorated files
-    // 3. Generate plans from sorted files
+    // 2. Group the decorated files by extension
+    // 3. Generate plans from the grouped files
+    const auto memory{std::pmr::new_delete_resource()};
     return generate(
-                sort_by_extension(decorate_with_extensions(std::move(raw_files))),
-                root_path
+                group_by_extension(decorate_with_extensions(raw_files, {}, memory)),
+                root_path,
+                nullptr
     );
   }
+
+  auto generate_plan(std::vector<fs::path>&& raw_files, const fs::path& root_path)
+              -> movement_plan
+  {
+    return generate_compact_plan(std::move(raw_files), root_path).to_movement_plan();
+  }
+
+  auto generate_compact_plan(
+              std::vector<fs::path>&& raw_files,
+              const fs::path&         root_path,
+              const planning_options& options
+  ) -> compact_plan
+  {
+    return generate_compact_plan(std::move(raw_files), {}, root_path, options);
+  }
+
+  auto generate_compact_plan(
+              std::vector<fs::path>&&              raw_files,
+              const std::span<const file_metadata> metadata,
+              const fs::path&                      root_path,
+              const planning_options&              options
+  ) -> compact_plan
+  {
+    const auto workers{resolve_worker_count(options.worker_count, raw_files.size())};
+    const auto rule_set{options.rules.get()};
+    const auto memory{arena::resource_or_heap(options.memory)};
+
+    if ( workers == 1 )
+      return generate(
+                  group_by_extension(
+                              decorate_with_extensions(raw_files, metadata, memory)
+                  ),
+                  root_path,
+                  rule_set
+      );
+
+    const auto shards{group_shards(raw_files, metadata, workers, memory)};
+    return generate_merged(shards, root_path, rule_set);
+  }
+
+  auto generate_plan(
+              std::vector<fs::path>&& raw_files,
+              const fs::path&         root_path,
+              const planning_options& options
+  ) -> movement_plan
+  {
+    return generate_compact_plan(std::move(raw_files), root_path, options)
+                .to_movement_plan();
+  }
 } // namespace fs_ops::planner
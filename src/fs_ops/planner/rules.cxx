@@ -0,0 +1,495 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+using namespace std::string_view_literals;
+
+namespace fs  = std::filesystem;
+namespace rng = std::ranges;
+
+using namespace fs_ops::rules;
+
+namespace
+{
+  constexpr auto blanks{" \t\r"sv};
+
+  // Size rules ending nowhere run up to the largest representable size
+  constexpr auto unbounded{std::numeric_limits<std::uint64_t>::max()};
+
+  // Displacements tried per group before the table is grown and rebuilt
+  constexpr std::uint32_t max_displacement{1U << 16};
+
+  // Doublings past the smallest table before the keys are searched instead,
+  // and the largest table ever built
+  constexpr int max_extra_slot_bits{4};
+  constexpr int max_slot_bits{32};
+
+  constexpr std::uint64_t golden_ratio{0x9E3779B97F4A7C15};
+
+  auto malformed() -> std::unexpected<std::error_code>
+  {
+    return std::unexpected{std::make_error_code(std::errc::invalid_argument)};
+  }
+
+  // FNV-1a; its low bits pick the key's group
+  constexpr auto hash_key(const std::string_view key) noexcept -> std::uint64_t
+  {
+    auto hash{std::uint64_t{0xCBF29CE484222325}};
+    for ( const auto c : key )
+    {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 0x100000001B3;
+    }
+    return hash;
+  }
+
+  // MurmurHash3's finalizer over hash + displacement; its top bits pick the slot
+  constexpr auto displace(const std::uint64_t hash, const std::uint32_t d) noexcept
+              -> std::uint64_t
+  {
+    auto mixed{hash + d * golden_ratio};
+    mixed ^= mixed >> 33;
+    mixed *= 0xFF51AFD7ED558CCD;
+    mixed ^= mixed >> 33;
+    return mixed;
+  }
+
+  auto trim(std::string_view text) -> std::string_view
+  {
+    const auto first{text.find_first_not_of(blanks)};
+    if ( first == std::string_view::npos )
+      return {};
+
+    text.remove_prefix(first);
+    return text.substr(0, text.find_last_not_of(blanks) + 1);
+  }
+
+  // Splits the next blank-separated word off text
+  auto next_word(std::string_view& text) -> std::string_view
+  {
+    text = trim(text);
+    const auto end{std::min(text.find_first_of(blanks), text.size())};
+    const auto word{text.substr(0, end)};
+    text.remove_prefix(end);
+    return word;
+  }
+
+  // "512", "4K", "100M", "1G" (powers of 1024)
+  auto parse_size(const std::string_view text) -> std::optional<std::uint64_t>
+  {
+    auto       value{std::uint64_t{0}};
+    const auto last{text.data() + text.size()};
+    const auto [end, ec]{std::from_chars(text.data(), last, value)};
+    if ( ec != std::errc{} or end == text.data() )
+      return std::nullopt;
+
+    const auto suffix{std::string_view{end, last}};
+    const auto shift{suffix.empty() ? 0
+                     : suffix == "K"sv or suffix == "k"sv ? 10
+                     : suffix == "M"sv or suffix == "m"sv ? 20
+                     : suffix == "G"sv or suffix == "g"sv ? 30
+                                                          : -1};
+    if ( shift < 0 or value > (unbounded >> shift) )
+      return std::nullopt;
+
+    return value << shift;
+  }
+
+  // A bucket becomes a directory directly below the root
+  auto valid_bucket(const std::string_view name) -> bool
+  {
+    return not name.empty() and name != "."sv and name != ".."sv
+           and name.find_first_of("/\\"sv) == std::string_view::npos;
+  }
+
+  auto to_extension(std::string_view word) -> std::string
+  {
+    if ( word == "none"sv )
+      return {};
+
+    if ( word.starts_with('.') )
+      word.remove_prefix(1);
+
+    auto lowered{std::string(word.size() + 1, '.')};
+    fs_ops::planner::ascii_lowercase(word, lowered.data() + 1);
+    return lowered;
+  }
+
+  struct size_rule
+  {
+    std::uint64_t first{0};
+    std::uint64_t last{unbounded};   // exclusive
+    std::uint32_t bucket{0};
+  };
+
+  // "size >= N", "size < N" or "size N..M"
+  auto parse_size_rule(std::string_view args, const std::uint32_t bucket)
+              -> std::optional<size_rule>
+  {
+    const auto op{next_word(args)};
+    auto       rule{size_rule{.bucket{bucket}}};
+
+    if ( op == ">="sv or op == "<"sv )
+    {
+      const auto bound{parse_size(next_word(args))};
+      if ( not bound )
+        return std::nullopt;
+
+      (op == ">="sv ? rule.first : rule.last) = *bound;
+    }
+    else if ( const auto dots{op.find(".."sv)}; dots != std::string_view::npos )
+    {
+      const auto first{parse_size(op.substr(0, dots))};
+      const auto last{parse_size(op.substr(dots + 2))};
+      if ( not first or not last )
+        return std::nullopt;
+
+      rule.first = *first;
+      rule.last  = *last;
+    }
+    else
+      return std::nullopt;
+
+    if ( not trim(args).empty() or rule.first >= rule.last )
+      return std::nullopt;
+
+    return rule;
+  }
+
+  // Cuts the overlapping rules into disjoint ranges at every boundary, each
+  // owned by the first rule covering it, and merges equal neighbours
+  template <typename Range>
+  auto flatten(const std::vector<size_rule>& rules) -> std::vector<Range>
+  {
+    auto bounds{std::vector<std::uint64_t>{0}};
+    for ( const auto& rule : rules )
+    {
+      bounds.push_back(rule.first);
+      bounds.push_back(rule.last);
+    }
+
+    rng::sort(bounds);
+    const auto duplicates{rng::unique(bounds)};
+    bounds.erase(duplicates.begin(), duplicates.end());
+
+    auto ranges{std::vector<Range>{}};
+    for ( const auto bound : bounds )
+    {
+      const auto owner{rng::find_if(rules, [bound](const size_rule& rule) {
+        return rule.first <= bound and bound < rule.last;
+      })};
+      const auto bucket{owner == rules.end() ? no_match : owner->bucket};
+
+      if ( ranges.empty() or ranges.back().bucket != bucket )
+        ranges.push_back({.first{bound}, .bucket{bucket}});
+    }
+
+    return ranges;
+  }
+} // namespace
+
+namespace fs_ops::rules
+{
+  auto extension_table::build(const std::vector<entry>& entries) -> extension_table
+  {
+    auto seen{std::unordered_set<std::string_view>{}};
+    auto unique{std::vector<const entry*>{}};
+    for ( const auto& candidate : entries )
+    {
+      if ( seen.insert(candidate.extension).second )
+        unique.push_back(&candidate);
+    }
+
+    auto table{extension_table{}};
+    if ( unique.empty() )
+      return table;
+
+    table.size_ = unique.size();
+    for ( const auto* const key : unique )
+      table.keys_ += key->extension;
+
+    // About four keys per group and at most half the slots used keep the
+    // displacement search short; a group that finds none grows the table
+    const auto groups{std::bit_ceil(std::max<std::size_t>(1, unique.size() / 4))};
+    auto       slot_bits{3};
+    while ( (std::size_t{1} << slot_bits) < 2 * unique.size() )
+      ++slot_bits;
+
+    auto hashes{std::vector<std::uint64_t>{}};
+    auto members{std::vector<std::vector<std::size_t>>(groups)};
+    for ( auto idx{std::size_t{0}}; idx < unique.size(); ++idx )
+    {
+      hashes.push_back(hash_key(unique[idx]->extension));
+      members[hashes.back() & (groups - 1)].push_back(idx);
+    }
+
+    // Largest groups first, while most slots are still free
+    auto order{std::vector<std::size_t>(groups)};
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    rng::stable_sort(order, rng::greater{}, [&members](const std::size_t group) {
+      return members[group].size();
+    });
+
+    const auto last_slot_bits{
+         std::min(slot_bits + max_extra_slot_bits, max_slot_bits)
+    };
+    for ( ; slot_bits <= last_slot_bits; ++slot_bits )
+    {
+      const auto shift{64 - slot_bits};
+      auto       slots{std::vector<slot>(std::size_t{1} << slot_bits)};
+      auto       displacements{std::vector<std::uint32_t>(groups)};
+      auto       placed{std::vector<std::uint64_t>{}};
+
+      const auto place_group{[&](const std::size_t group) {
+        for ( auto d{std::uint32_t{0}}; d < max_displacement; ++d )
+        {
+          placed.clear();
+          for ( const auto idx : members[group] )
+          {
+            const auto at{displace(hashes[idx], d) >> shift};
+            const auto clash{rng::find(placed, at) != placed.end()};
+            if ( clash or slots[at].bucket != no_match )
+              break;
+            placed.push_back(at);
+          }
+
+          if ( placed.size() != members[group].size() )
+            continue;
+
+          for ( auto member{std::size_t{0}}; member < placed.size(); ++member )
+            slots[placed[member]].bucket = unique[members[group][member]]->bucket;
+          displacements[group] = d;
+          return true;
+        }
+        return false;
+      }};
+
+      if ( not rng::all_of(order, place_group) )
+        continue;
+
+      // Key offsets into the arena, which holds the keys in `unique` order
+      auto offset{std::uint32_t{0}};
+      for ( auto idx{std::size_t{0}}; idx < unique.size(); ++idx )
+      {
+        const auto length{static_cast<std::uint32_t>(unique[idx]->extension.size())};
+        const auto group{hashes[idx] & (groups - 1)};
+        const auto at{displace(hashes[idx], displacements[group]) >> shift};
+
+        slots[at].key_offset = offset;
+        slots[at].key_length = length;
+        offset += length;
+      }
+
+      table.slots_         = std::move(slots);
+      table.displacements_ = std::move(displacements);
+      table.group_mask_    = groups - 1;
+      table.slot_shift_    = shift;
+      return table;
+    }
+
+    for ( const auto* const key : unique )
+      table.sorted_.push_back(*key);
+    rng::sort(table.sorted_, {}, &entry::extension);
+    return table;
+  }
+
+  auto extension_table::find(const std::string_view extension) const noexcept
+              -> std::uint32_t
+  {
+    if ( size_ == 0 )
+      return no_match;
+
+    if ( slots_.empty() )
+    {
+      const auto found{rng::lower_bound(sorted_, extension, {}, &entry::extension)};
+      return found != sorted_.end() and found->extension == extension ? found->bucket
+                                                                     : no_match;
+    }
+
+    const auto hash{hash_key(extension)};
+    const auto d{displacements_[hash & group_mask_]};
+    const auto& candidate{slots_[displace(hash, d) >> slot_shift_]};
+    const auto key{
+         std::string_view{keys_}.substr(candidate.key_offset, candidate.key_length)
+    };
+
+    return candidate.bucket != no_match and key == extension ? candidate.bucket
+                                                             : no_match;
+  }
+
+  auto rule_set::parse(const std::string_view text) -> Result<rule_set>
+  {
+    auto rules{rule_set{}};
+    auto ids{std::unordered_map<std::string, std::uint32_t>{}};
+    auto extensions{std::vector<extension_table::entry>{}};
+    auto sizes{std::vector<size_rule>{}};
+
+    auto intern{[&rules, &ids](const std::string_view name) {
+      const auto [slot, inserted]{ids.try_emplace(
+                   std::string{name},
+                   static_cast<std::uint32_t>(rules.buckets_.size())
+      )};
+      if ( inserted )
+        rules.buckets_.emplace_back(name);
+      return slot->second;
+    }};
+
+    auto rest{text};
+    while ( not rest.empty() )
+    {
+      const auto newline{std::min(rest.find('\n'), rest.size())};
+      auto       line{rest.substr(0, newline)};
+      rest.remove_prefix(std::min(newline + 1, rest.size()));
+
+      line = trim(line.substr(0, line.find('#')));
+      if ( line.empty() )
+        continue;
+
+      const auto colon{line.find(':')};
+      if ( colon == std::string_view::npos )
+        return malformed();
+
+      const auto name{trim(line.substr(0, colon))};
+      auto       args{line.substr(colon + 1)};
+      const auto shape{next_word(args)};
+
+      if ( not valid_bucket(name) or trim(args).empty() )
+        return malformed();
+
+      const auto bucket{intern(name)};
+
+      if ( shape == "ext"sv )
+      {
+        for ( auto word{next_word(args)}; not word.empty(); word = next_word(args) )
+          extensions.push_back({.extension{to_extension(word)}, .bucket{bucket}});
+      }
+      else if ( shape == "prefix"sv )
+      {
+        for ( auto word{next_word(args)}; not word.empty(); word = next_word(args) )
+          rules.prefixes_.push_back({.prefix{std::string{word}}, .bucket{bucket}});
+      }
+      else if ( shape == "size"sv )
+      {
+        const auto rule{parse_size_rule(args, bucket)};
+        if ( not rule )
+          return malformed();
+        sizes.push_back(*rule);
+      }
+      else
+        return malformed();
+    }
+
+    rules.extensions_ = extension_table::build(extensions);
+    rules.sizes_      = sizes.empty() ? std::vector<size_range>{}
+                                      : flatten<size_range>(sizes);
+
+    // Stable, so rules sharing a first byte keep their file order
+    const auto first_byte{[](const prefix_rule& rule) {
+      return static_cast<unsigned char>(rule.prefix.front());
+    }};
+    rng::stable_sort(rules.prefixes_, {}, first_byte);
+
+    auto next{std::uint32_t{0}};
+    for ( auto byte{std::size_t{0}}; byte < rules.prefix_starts_.size(); ++byte )
+    {
+      while ( next < rules.prefixes_.size()
+              and std::size_t{first_byte(rules.prefixes_[next])} < byte )
+        ++next;
+      rules.prefix_starts_[byte] = next;
+    }
+
+    return rules;
+  }
+
+  auto rule_set::load(const fs::path& file) -> Result<rule_set>
+  {
+    auto in{std::ifstream{file}};
+    if ( not in )
+      return std::unexpected{
+                   std::make_error_code(std::errc::no_such_file_or_directory)
+      };
+
+    const auto text{std::string(
+                std::istreambuf_iterator<char>{in},
+                std::istreambuf_iterator<char>{}
+    )};
+    return parse(text);
+  }
+
+  auto rule_set::bucket_count() const noexcept -> std::size_t
+  {
+    return buckets_.size();
+  }
+
+  auto rule_set::bucket_name(const std::uint32_t bucket) const -> const std::string&
+  {
+    return buckets_[bucket];
+  }
+
+  auto rule_set::has_prefix_rules() const noexcept -> bool
+  {
+    return not prefixes_.empty();
+  }
+
+  auto rule_set::has_size_rules() const noexcept -> bool
+  {
+    return not sizes_.empty();
+  }
+
+  auto rule_set::match_extension(const std::string_view extension) const noexcept
+              -> std::uint32_t
+  {
+    return extensions_.find(extension);
+  }
+
+  auto rule_set::match_prefix(const std::string_view name) const noexcept
+              -> std::uint32_t
+  {
+    if ( name.empty() )
+      return no_match;
+
+    const auto byte{static_cast<unsigned char>(name.front())};
+    for ( auto idx{prefix_starts_[byte]}; idx < prefix_starts_[byte + 1U]; ++idx )
+    {
+      if ( name.starts_with(prefixes_[idx].prefix) )
+        return prefixes_[idx].bucket;
+    }
+
+    return no_match;
+  }
+
+  auto rule_set::match_size(const std::uint64_t size) const noexcept -> std::uint32_t
+  {
+    // The first range starts at 0, so there always is one at or below size
+    const auto above{rng::upper_bound(sizes_, size, {}, &size_range::first)};
+    return above == sizes_.begin() ? no_match : std::prev(above)->bucket;
+  }
+} // namespace fs_ops::rules
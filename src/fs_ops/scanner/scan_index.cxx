@@ -0,0 +1,370 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs = std::filesystem;
+
+using namespace fs_ops::scanner;
+
+namespace
+{
+  constexpr auto index_magic{
+       std::array<char, 8>{'F', 'J', 'I', 'N', 'D', 'E', 'X', 0}
+  };
+  constexpr std::uint32_t index_version{2};
+
+  // A directory modified this recently may change again within the same mtime
+  // tick (coarse on some filesystems), so its mtime is not trusted until a
+  // later rescan sees it settled
+  constexpr std::int64_t mtime_settle_ns{2'000'000'000};
+  constexpr auto         unsettled_mtime{std::numeric_limits<std::int64_t>::min()};
+
+  auto now_ns() -> std::int64_t
+  {
+    using std::chrono::nanoseconds;
+
+    const auto now{std::chrono::system_clock::now().time_since_epoch()};
+    return std::chrono::duration_cast<nanoseconds>(now).count();
+  }
+
+  auto record_error(file_collection& found, const std::error_code ec) -> void
+  {
+    // Entries that vanish between listing and stat are not errors
+    if ( ec != std::errc::no_such_file_or_directory )
+      found.error_bin.push_back(ec);
+  }
+
+  // Fixed-width fields and length-prefixed strings, in host byte order; an
+  // index is only ever read back by the host that wrote it
+  class index_writer
+  {
+  public:
+    explicit index_writer(std::ofstream& out)
+        : out_{out}
+    {}
+
+    template <typename T>
+    auto put(const T value) -> void
+    {
+      out_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    auto put(const std::string& text) -> void
+    {
+      put<std::uint32_t>(static_cast<std::uint32_t>(text.size()));
+      out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+  private:
+    std::ofstream& out_;
+  };
+
+  // Keeps count of the bytes left in the file, so a corrupt length prefix
+  // fails the read instead of allocating whatever it says
+  class index_reader
+  {
+  public:
+    index_reader(std::ifstream& in, const std::uintmax_t size)
+        : in_{in},
+          remaining_{size}
+    {}
+
+    template <typename T>
+    auto get() -> T
+    {
+      auto value{T{}};
+      in_.read(reinterpret_cast<char*>(&value), sizeof(T));
+      remaining_ -= std::min<std::uintmax_t>(sizeof(T), remaining_);
+      return value;
+    }
+
+    auto get_string() -> std::string
+    {
+      const auto length{get<std::uint32_t>()};
+      if ( length > remaining_ )
+      {
+        in_.setstate(std::ios::failbit);
+        return {};
+      }
+
+      auto text{std::string(length, '\0')};
+      in_.read(text.data(), static_cast<std::streamsize>(text.size()));
+      remaining_ -= length;
+      return text;
+    }
+
+    [[nodiscard]] auto ok() const -> bool { return static_cast<bool>(in_); }
+
+  private:
+    std::ifstream& in_;
+    std::uintmax_t remaining_;
+  };
+} // namespace
+
+namespace fs_ops::scanner
+{
+  auto scan_index::load(const fs::path& file) -> Result<scan_index>
+  {
+    auto in{std::ifstream{file, std::ios::binary}};
+    if ( not in )
+      return std::unexpected{
+                   std::make_error_code(std::errc::no_such_file_or_directory)
+      };
+
+    auto       ec{std::error_code{}};
+    const auto size{fs::file_size(file, ec)};
+    if ( ec )
+      return std::unexpected{ec};
+
+    auto magic{std::array<char, 8>{}};
+    in.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+
+    const auto body{size - std::min<std::uintmax_t>(size, magic.size())};
+    auto       reader{index_reader{in, body}};
+
+    if ( magic != index_magic or reader.get<std::uint32_t>() != index_version )
+      return std::unexpected{std::make_error_code(std::errc::bad_message)};
+
+    auto index{scan_index{}};
+    const auto directory_count{reader.get<std::uint64_t>()};
+
+    for ( auto dir{std::uint64_t{0}}; dir < directory_count and reader.ok(); ++dir )
+    {
+      auto key{reader.get_string()};
+      auto record{directory_record{.mtime_ns{reader.get<std::int64_t>()}}};
+
+      const auto subdir_count{reader.get<std::uint32_t>()};
+      for ( auto sub{std::uint32_t{0}}; sub < subdir_count and reader.ok(); ++sub )
+        record.subdirs.push_back(reader.get_string());
+
+      const auto file_count{reader.get<std::uint64_t>()};
+      for ( auto idx{std::uint64_t{0}}; idx < file_count and reader.ok(); ++idx )
+      {
+        auto name{reader.get_string()};
+        record.files.emplace(
+                    std::move(name),
+                    safe_fs::file_stamp{
+                         .type{reader.get<safe_fs::entry_type>()},
+                         .device{reader.get<std::uint64_t>()},
+                         .inode{reader.get<std::uint64_t>()},
+                         .size{reader.get<std::uint64_t>()},
+                         .mtime_ns{reader.get<std::int64_t>()}
+                    }
+        );
+      }
+
+      index.directories_.emplace(std::move(key), std::move(record));
+    }
+
+    if ( not reader.ok() )
+      return std::unexpected{std::make_error_code(std::errc::bad_message)};
+
+    return index;
+  }
+
+  auto scan_index::save(const fs::path& file) const -> VoidResult
+  {
+    auto temporary{file};
+    temporary += ".tmp";
+
+    {
+      auto out{std::ofstream{temporary, std::ios::binary | std::ios::trunc}};
+      auto writer{index_writer{out}};
+
+      out.write(index_magic.data(), index_magic.size());
+      writer.put<std::uint32_t>(index_version);
+      writer.put<std::uint64_t>(directories_.size());
+
+      for ( const auto& [key, record] : directories_ )
+      {
+        writer.put(key);
+        writer.put<std::int64_t>(record.mtime_ns);
+        writer.put(static_cast<std::uint32_t>(record.subdirs.size()));
+        for ( const auto& subdir : record.subdirs )
+          writer.put(subdir);
+
+        writer.put<std::uint64_t>(record.files.size());
+        for ( const auto& [name, stamp] : record.files )
+        {
+          writer.put(name);
+          writer.put<safe_fs::entry_type>(stamp.type);
+          writer.put<std::uint64_t>(stamp.device);
+          writer.put<std::uint64_t>(stamp.inode);
+          writer.put<std::uint64_t>(stamp.size);
+          writer.put<std::int64_t>(stamp.mtime_ns);
+        }
+      }
+
+      out.flush();
+      if ( not out )
+        return std::unexpected{std::make_error_code(std::errc::io_error)};
+    }
+
+    // Renamed only once its data is on disk, so a crash leaves either index
+    return safe_fs::sync_file(temporary).and_then([&temporary, &file] {
+      return safe_fs::rename(temporary, file);
+    });
+  }
+
+  auto scan_index::relist(
+              const fs::path&   dir,
+              directory_record& record,
+              file_collection&  found
+  ) -> void
+  {
+    auto files{std::unordered_map<std::string, safe_fs::file_stamp>{}};
+    auto subdirs{std::vector<std::string>{}};
+
+    for ( auto&& entry : safe_fs::native_scan(dir) )
+    {
+      if ( not entry )
+      {
+        // Keep what was listed, but have the next rescan list it again
+        record_error(found, entry.error());
+        record.mtime_ns = unsettled_mtime;
+        break;
+      }
+
+      if ( entry->type == safe_fs::entry_type::directory )
+      {
+        subdirs.emplace_back(entry->name);
+        continue;
+      }
+
+      if ( entry->type == safe_fs::entry_type::other )
+        continue;
+
+      // Size and mtime are not part of the listing, so every candidate file
+      // costs one stat; this only happens in directories that changed
+      auto       name{std::string{entry->name}};
+      auto       path{dir / name};
+      const auto stamp{safe_fs::stamp(path)};
+
+      if ( not stamp )
+      {
+        record_error(found, stamp.error());
+        continue;
+      }
+
+      // d_type unknown: the stat decides. Symlinked directories stay unvisited.
+      if ( stamp->type == safe_fs::entry_type::directory )
+      {
+        if ( entry->type == safe_fs::entry_type::unknown )
+          subdirs.push_back(std::move(name));
+        continue;
+      }
+
+      if ( stamp->type != safe_fs::entry_type::regular )
+        continue;
+
+      if ( const auto previous{record.files.find(name)};
+           previous == record.files.end() or previous->second != *stamp )
+      {
+        found.file_bin.push_back(std::move(path));
+        // With d_type unknown, whether the name is a symlink is not known either
+        found.metadata_bin.push_back({
+             .device{stamp->device},
+             .inode{stamp->inode},
+             .size{stamp->size},
+             .mtime_ns{stamp->mtime_ns},
+             .symlink{entry->type == safe_fs::entry_type::symlink},
+             .known{entry->type != safe_fs::entry_type::unknown},
+        });
+      }
+
+      files.emplace(std::move(name), *stamp);
+    }
+
+    record.files   = std::move(files);
+    record.subdirs = std::move(subdirs);
+  }
+
+  auto scan_index::rescan(
+              const fs::path&     target_directory,
+              const scan_options& options
+  ) -> file_collection
+  {
+    auto found{file_collection{}};
+    auto visited{std::unordered_map<std::string, directory_record>{}};
+    auto pending{std::vector<std::pair<fs::path, int>>{{target_directory, 0}}};
+
+    const auto settled_before{now_ns() - mtime_settle_ns};
+
+    while ( not pending.empty() )
+    {
+      auto [dir, depth]{std::move(pending.back())};
+      pending.pop_back();
+
+      auto key{dir.string()};
+      if ( visited.contains(key) )
+        continue;
+
+      const auto dir_stamp{safe_fs::stamp(dir)};
+      if ( not dir_stamp )
+      {
+        record_error(found, dir_stamp.error());
+        continue;
+      }
+
+      auto record{[this, &key] {
+        auto previous{directories_.extract(key)};
+        return previous ? std::move(previous.mapped()) : directory_record{};
+      }()};
+
+      const auto mtime{dir_stamp->mtime_ns};
+      if ( record.mtime_ns == unsettled_mtime or record.mtime_ns != mtime )
+      {
+        record.mtime_ns = mtime < settled_before ? mtime : unsettled_mtime;
+        relist(dir, record, found);
+      }
+
+      const auto descend{options.recursive
+                         and (options.max_depth < 0 or depth < options.max_depth)};
+      if ( descend )
+      {
+        for ( const auto& subdir : record.subdirs )
+          pending.emplace_back(dir / subdir, depth + 1);
+      }
+
+      visited.emplace(std::move(key), std::move(record));
+    }
+
+    // Directories that were not reached this time are dropped
+    directories_ = std::move(visited);
+    return found;
+  }
+
+  auto scan_index::forget(const fs::path& file) -> void
+  {
+    const auto found{directories_.find(file.parent_path().string())};
+    if ( found == directories_.end() )
+      return;
+
+    found->second.files.erase(file.filename().string());
+    found->second.mtime_ns = unsettled_mtime;
+  }
+} // namespace fs_ops::scanner
@@ -6,11 +6,28 @@ module;
 
 // Standard headers in GMF
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
 #include <filesystem>
+#include <generator>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
 #include <ranges>
-#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include <xxhash.h>
+
 module filejanitor;
 
 // NO import std; - use GMF includes for consistency
@@ -19,48 +36,508 @@ namespace fs  = std::filesystem;
 namespace rng = std::ranges;
 namespace vws = std::views;
 
+using namespace fs_ops::scanner;
+
 namespace
 {
-  auto get_raw_results(const fs::path& target_directory) -> std::vector<ScanResult>
+  // What the scanner needs to know about one entry, whichever backend listed it.
+  // `directory` follows symlinks; `symlink` says whether the entry itself is one.
+  // metadata is known only for regular files, and only when it was asked for.
+  struct listed_entry
+  {
+    fs::path                path;
+    bool                    regular{false};
+    bool                    directory{false};
+    bool                    symlink{false};
+    std::error_code         status_error{};
+    fs_ops::file_metadata   metadata{};
+  };
+
+  using ListResult = Result<listed_entry>;
+
+  // Every listed directory costs one generator frame; handed an allocator
+  // through allocator_arg, the frame comes out of the run's memory instead
+  using frame_allocator = std::pmr::polymorphic_allocator<>;
+
+  auto metadata_of(const safe_fs::file_stamp& stamp, const bool symlink) noexcept
+              -> fs_ops::file_metadata
+  {
+    return {
+         .device{stamp.device},
+         .inode{stamp.inode},
+         .size{stamp.size},
+         .mtime_ns{stamp.mtime_ns},
+         .symlink{symlink},
+         .known{true},
+    };
+  }
+
+  // Takes type, inode, size and mtime from one statx of the symlink's target
+  // (or the file itself); the listing only ever said it was regular
+  auto read_metadata(listed_entry& entry) -> void
+  {
+    const auto stamp{safe_fs::probe(entry.path, true, true)};
+    if ( not stamp )
+    {
+      entry.status_error = stamp.error();
+      return;
+    }
+
+    entry.regular = stamp->type == safe_fs::entry_type::regular;
+    if ( entry.regular )
+      entry.metadata = metadata_of(*stamp, entry.symlink);
+  }
+
+  auto list_standard(
+              std::allocator_arg_t,
+              [[maybe_unused]] const frame_allocator& frames,
+              const fs::path                          dir,
+              const bool                              detailed
+  ) -> std::generator<ListResult>
+  {
+    for ( auto&& result : safe_fs::safe_scan(dir) )
+    {
+      if ( not result )
+      {
+        co_yield std::unexpected{result.error()};
+        continue;
+      }
+
+      // The one copy of the path, which file_bin keeps. Each query clears
+      // status_error on success, so a failure that persists across all three
+      // is the one left behind.
+      auto entry{listed_entry{.path{result->path()}}};
+      entry.symlink   = result->is_symlink(entry.status_error);
+      entry.regular   = result->is_regular_file(entry.status_error);
+      entry.directory = result->is_directory(entry.status_error);
+
+      if ( detailed and entry.regular )
+        read_metadata(entry);
+
+      co_yield ListResult{std::move(entry)};
+    }
+  }
+
+  // d_type answers directly for regular files and directories. Symlinks, and
+  // filesystems that leave d_type unset, take one statx asking only for what is
+  // needed; an unknown entry that turns out to be a symlink takes a second one
+  // through it. Regular files are queried only when `detailed`.
+  auto classify(
+              listed_entry&             entry,
+              const safe_fs::entry_type type,
+              const bool                detailed
+  ) -> void
+  {
+    using enum safe_fs::entry_type;
+
+    switch ( type )
+    {
+    case regular:
+      entry.regular = true;
+      if ( detailed )
+        read_metadata(entry);
+      return;
+    case directory: entry.directory = true; return;
+    case symlink:   entry.symlink = true; break;
+    case unknown:   break;
+    case other:     return;
+    }
+
+    auto stamp{safe_fs::probe(entry.path, entry.symlink, detailed)};
+    if ( stamp and stamp->type == symlink )
+    {
+      entry.symlink = true;
+      stamp         = safe_fs::probe(entry.path, true, detailed);
+    }
+
+    if ( not stamp )
+    {
+      entry.status_error = stamp.error();
+      return;
+    }
+
+    entry.regular   = stamp->type == regular;
+    entry.directory = stamp->type == directory;
+    if ( detailed and entry.regular )
+      entry.metadata = metadata_of(*stamp, entry.symlink);
+  }
+
+  auto list_native(
+              std::allocator_arg_t,
+              [[maybe_unused]] const frame_allocator& frames,
+              const fs::path                          dir,
+              const bool                              detailed
+  ) -> std::generator<ListResult>
+  {
+    for ( auto&& result : safe_fs::native_scan(dir) )
+    {
+      if ( not result )
+      {
+        co_yield std::unexpected{result.error()};
+        continue;
+      }
+
+      if ( result->type == safe_fs::entry_type::other )
+        continue;
+
+      // The only allocation per entry: the owned path handed on to file_bin
+      auto entry{listed_entry{.path{safe_fs::join(dir, {result->name})}}};
+      classify(entry, result->type, detailed);
+
+      co_yield ListResult{std::move(entry)};
+    }
+  }
+
+  auto list_directory(
+              fs::path                         dir,
+              const scan_options&              options,
+              std::pmr::memory_resource* const memory
+  ) -> std::generator<ListResult>
+  {
+    const auto frames{frame_allocator{memory}};
+    const auto detailed{options.collect_metadata};
+    return options.backend == scan_backend::native
+           ? list_native(std::allocator_arg, frames, std::move(dir), detailed)
+           : list_standard(std::allocator_arg, frames, std::move(dir), detailed);
+  }
+
+  // Broken symlinks report not-found from their status query; they are simply
+  // not regular files, not scan errors.
+  auto record_error(file_collection& bins, const std::error_code ec) -> void
+  {
+    if ( ec and ec != std::errc::no_such_file_or_directory )
+      bins.error_bin.push_back(ec);
+  }
+
+  // Sorts one scan result straight into its bin, so no intermediate copy of the
+  // listing is ever held
+  auto bin_result(file_collection& bins, ListResult&& result, const bool detailed)
+              -> void
+  {
+    if ( not result )
+    {
+      bins.error_bin.push_back(result.error());
+      return;
+    }
+
+    if ( result->regular )
+    {
+      bins.file_bin.push_back(std::move(result->path));
+      if ( detailed )
+        bins.metadata_bin.push_back(result->metadata);
+    }
+
+    record_error(bins, result->status_error);
+  }
+
+  // Only the root's own entries are split; listing errors are kept by every
+  // shard, since none of them can tell whose entry failed
+  auto in_shard(const scan_shard& shard, const ListResult& result) -> bool
+  {
+    if ( shard.count <= 1 or not result )
+      return true;
+
+    return shard.owns(result->path.filename().string());
+  }
+
+  auto collect_flat(
+              const fs::path&                  target_directory,
+              const scan_options&              options,
+              std::pmr::memory_resource* const memory
+  ) -> file_collection
+  {
+    // 1. Reserve the file (and metadata) bins from the directory's size hint
+    // 2. Bin every result as it is produced: files, errors, or neither
+    const auto detailed{options.collect_metadata};
+    const auto hint{safe_fs::entry_count_hint(target_directory).value_or(0)};
+
+    auto bins{file_collection{}};
+    bins.file_bin.reserve(hint);
+    if ( detailed )
+      bins.metadata_bin.reserve(hint);
+
+    for ( auto&& result : list_directory(target_directory, options, memory) )
+    {
+      if ( in_shard(options.shard, result) )
+        bin_result(bins, std::move(result), detailed);
+    }
+
+    return bins;
+  }
+
+  struct directory_task
+  {
+    fs::path path;
+    int      depth{};
+  };
+
+  // One per worker. The owner pushes and pops at the back, so its own walk stays
+  // depth-first; idle workers steal from the front, which holds the oldest and
+  // usually largest pending subtrees.
+  class work_stealing_queue
+  {
+  public:
+    auto push(directory_task&& task) -> void
+    {
+      const auto lock{std::scoped_lock{mutex_}};
+      tasks_.push_back(std::move(task));
+    }
+
+    auto pop() -> std::optional<directory_task>
+    {
+      const auto lock{std::scoped_lock{mutex_}};
+      if ( tasks_.empty() )
+        return std::nullopt;
+
+      auto task{std::move(tasks_.back())};
+      tasks_.pop_back();
+      return task;
+    }
+
+    auto steal() -> std::optional<directory_task>
+    {
+      const auto lock{std::scoped_lock{mutex_}};
+      if ( tasks_.empty() )
+        return std::nullopt;
+
+      auto task{std::move(tasks_.front())};
+      tasks_.pop_front();
+      return task;
+    }
+
+  private:
+    std::mutex                 mutex_{};
+    std::deque<directory_task> tasks_{};
+  };
+
+  struct scan_state
+  {
+    const scan_options&              options;
+    std::pmr::memory_resource*       memory;
+    std::vector<work_stealing_queue> queues;
+    std::atomic<std::size_t>         pending{0}; // queued or in-progress directories
+    std::atomic<std::uint64_t>       work_epoch{0}; // bumped per push and at the end
+    std::mutex                       visited_mutex{};
+    arena::string_set                visited;
+  };
+
+  auto resolve_worker_count(const scan_options& options) -> std::size_t
+  {
+    const auto hardware{std::size_t{std::thread::hardware_concurrency()}};
+    return options.worker_count != 0 ? options.worker_count
+                                     : std::max<std::size_t>(1, hardware);
+  }
+
+  // Following symlinks can revisit a directory (or loop forever), so every
+  // directory is claimed by its canonical path first. Without following, the
+  // tree is acyclic and the canonical lookup is skipped entirely.
+  auto claim_directory(scan_state& state, const fs::path& dir) -> Result<bool>
+  {
+    if ( state.options.symlinks != symlink_policy::follow )
+      return true;
+
+    auto ec{std::error_code{}};
+    auto canonical{fs::canonical(dir, ec)};
+    if ( ec )
+      return std::unexpected{ec};
+
+    const auto lock{std::scoped_lock{state.visited_mutex}};
+    return state.visited.emplace(canonical.string()).second;
+  }
+
+  auto within_depth(const scan_state& state, const int depth) -> bool
+  {
+    return state.options.max_depth < 0 or depth < state.options.max_depth;
+  }
+
+  // A directory that cannot be claimed is left out, and why goes to local
+  auto should_descend(
+              scan_state&         state,
+              const listed_entry& entry,
+              const int           depth,
+              file_collection&    local
+  ) -> bool
+  {
+    if ( not entry.directory or not within_depth(state, depth) )
+      return false;
+
+    if ( entry.symlink and state.options.symlinks == symlink_policy::skip )
+      return false;
+
+    const auto claimed{claim_directory(state, entry.path)};
+    if ( not claimed )
+      record_error(local, claimed.error());
+
+    return claimed.value_or(false);
+  }
+
+  // Wakes one parked worker; the epoch changing is what a waiter checks for
+  auto announce_work(scan_state& state) -> void
+  {
+    state.work_epoch.fetch_add(1);
+    state.work_epoch.notify_one();
+  }
+
+  auto scan_directory(
+              scan_state&       state,
+              const std::size_t self,
+              directory_task&&  task,
+              file_collection&  local
+  ) -> void
+  {
+    const auto& options{state.options};
+    auto        listing{list_directory(std::move(task.path), options, state.memory)};
+
+    for ( auto&& result : listing )
+    {
+      if ( task.depth == 0 and not in_shard(options.shard, result) )
+        continue;
+
+      if ( result and should_descend(state, *result, task.depth, local) )
+      {
+        state.pending.fetch_add(1);
+        state.queues[self].push(
+                    {.path{std::move(result->path)}, .depth{task.depth + 1}}
+        );
+        announce_work(state);
+        continue;
+      }
+
+      bin_result(local, std::move(result), options.collect_metadata);
+    }
+  }
+
+  auto next_task(scan_state& state, const std::size_t self)
+              -> std::optional<directory_task>
   {
-    return rng::to<std::vector>(safe_fs::safe_scan(target_directory));
+    if ( auto task{state.queues[self].pop()} )
+      return task;
+
+    const auto count{state.queues.size()};
+    for ( const auto offset : vws::iota(std::size_t{1}, count) )
+    {
+      if ( auto task{state.queues[(self + offset) % count].steal()} )
+        return task;
+    }
+
+    return std::nullopt;
   }
 
-  auto split(std::vector<ScanResult>& raw_results) -> auto
+  // An idle worker parks on work_epoch until a directory is pushed or the scan
+  // ends. The epoch is read before looking for work, so a push that lands
+  // after the search came up empty still wakes it.
+  auto run_worker(scan_state& state, const std::size_t self) -> file_collection
   {
-    return rng::partition(raw_results, [](const auto& result) {
-      return result.has_value();
-    });
+    auto local{file_collection{}};
+
+    while ( state.pending.load() > 0 )
+    {
+      const auto epoch{state.work_epoch.load()};
+      auto       task{next_task(state, self)};
+      if ( not task )
+      {
+        if ( state.pending.load() > 0 )
+          state.work_epoch.wait(epoch);
+        continue;
+      }
+
+      scan_directory(state, self, std::move(*task), local);
+      if ( state.pending.fetch_sub(1) == 1 )
+      {
+        // Last directory done: everyone still parked can go
+        state.work_epoch.fetch_add(1);
+        state.work_epoch.notify_all();
+      }
+    }
+
+    return local;
+  }
+
+  auto merge(std::vector<file_collection>&& parts) -> file_collection
+  {
+    auto total_files{std::size_t{0}};
+    auto total_errors{std::size_t{0}};
+    auto total_metadata{std::size_t{0}};
+    for ( const auto& part : parts )
+    {
+      total_files += part.file_bin.size();
+      total_errors += part.error_bin.size();
+      total_metadata += part.metadata_bin.size();
+    }
+
+    auto merged{file_collection{}};
+    merged.file_bin.reserve(total_files);
+    merged.error_bin.reserve(total_errors);
+    merged.metadata_bin.reserve(total_metadata);
+
+    for ( auto& [files, errors, metadata] : parts )
+    {
+      rng::move(files, std::back_inserter(merged.file_bin));
+      rng::copy(errors, std::back_inserter(merged.error_bin));
+      rng::copy(metadata, std::back_inserter(merged.metadata_bin));
+    }
+
+    return merged;
+  }
+
+  auto scan_recursive(const fs::path& root, const scan_options& options)
+              -> file_collection
+  {
+    const auto worker_count{resolve_worker_count(options)};
+    const auto memory{arena::resource_or_heap(options.memory)};
+
+    auto state{scan_state{
+         .options{options},
+         .memory{memory},
+         .queues = std::vector<work_stealing_queue>(worker_count),
+         .visited = arena::string_set{memory},
+    }};
+
+    // A root that cannot be canonicalized will fail in safe_scan as well, and
+    // that is where its error gets reported
+    static_cast<void>(claim_directory(state, root));
+
+    state.pending.store(1);
+    state.queues.front().push({.path{root}, .depth{0}});
+
+    auto parts{std::vector<file_collection>(worker_count)};
+    {
+      auto workers{std::vector<std::jthread>{}};
+      workers.reserve(worker_count);
+
+      for ( const auto self : vws::iota(std::size_t{0}, worker_count) )
+      {
+        workers.emplace_back([&state, &parts, self] {
+          parts[self] = run_worker(state, self);
+        });
+      }
+    } // jthreads join here
+
+    return merge(std::move(parts));
   }
 } // namespace
 
 namespace fs_ops::scanner
 {
+  auto scan_shard::owns(const std::string_view name) const noexcept -> bool
+  {
+    return count <= 1 or XXH3_64bits(name.data(), name.size()) % count == index;
+  }
+
   auto collect_files(const fs::path& target_directory) -> file_collection
   {
-    // 1. Collects raw results
-    // 2. Partitions raw results
-    // 3. Collect valid files
-    // 4. Collect errors
-    return [raw_results{get_raw_results(target_directory)}] mutable {
-      return [raw_begin{raw_results.begin()},
-              split_point{split(raw_results)}] -> file_collection {
-        return {
-             .file_bin{
-                  std::span{raw_begin, split_point.begin()}
-                  | vws::filter([](const ScanResult& r) {
-                      return r->is_regular_file();
-                    })
-                  | vws::transform([](const ScanResult& r) { return r->path(); })
-                  | rng::to<std::vector>()
-             },
-             .error_bin{
-                  std::span{split_point}
-                  | vws::transform([](const ScanResult& r) { return r.error(); })
-                  | rng::to<std::vector>()
-             }
-        };
-      }();
-    }();
+    const auto memory{std::pmr::new_delete_resource()};
+    return collect_flat(target_directory, scan_options{}, memory);
+  }
+
+  auto collect_files(const fs::path& target_directory, const scan_options& options)
+              -> file_collection
+  {
+    return options.recursive ? scan_recursive(target_directory, options)
+                             : collect_flat(
+                                         target_directory,
+                                         options,
+                                         arena::resource_or_heap(options.memory)
+                               );
   }
 } // namespace fs_ops::scanner
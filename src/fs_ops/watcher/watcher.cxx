@@ -0,0 +1,345 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#  include <poll.h>
+#  include <sys/eventfd.h>
+#  include <sys/inotify.h>
+#  include <unistd.h>
+#endif
+
+module filejanitor;
+
+// NO import std; - use GMF includes for consistency
+
+namespace fs = std::filesystem;
+
+using namespace fs_ops;
+using namespace fs_ops::watcher;
+
+#if defined(__linux__)
+namespace
+{
+  using clock = std::chrono::steady_clock;
+
+  // Events that mean "a file may now be complete"; IN_MODIFY only pushes back
+  // the deadline of a file that is already pending
+  constexpr std::uint32_t arrival_mask{IN_CLOSE_WRITE | IN_MOVED_TO};
+  constexpr std::uint32_t watch_mask{
+       arrival_mask | IN_MODIFY | IN_DELETE_SELF | IN_MOVE_SELF
+  };
+
+  constexpr std::size_t event_buffer_size{64UZ * 1024UZ};
+
+  auto last_error() -> std::error_code
+  {
+    return {errno, std::system_category()};
+  }
+
+  // Owns the inotify and eventfd descriptors
+  class unique_fd
+  {
+  public:
+    explicit unique_fd(const int fd) noexcept
+        : fd_{fd}
+    {}
+
+    unique_fd(const unique_fd&)                    = delete;
+    auto operator=(const unique_fd&) -> unique_fd& = delete;
+
+    ~unique_fd()
+    {
+      if ( fd_ >= 0 )
+        ::close(fd_);
+    }
+
+    [[nodiscard]] auto get() const noexcept -> int { return fd_; }
+    [[nodiscard]] auto valid() const noexcept -> bool { return fd_ >= 0; }
+
+  private:
+    int fd_{-1};
+  };
+
+  // Files seen arriving, each with the time it may be moved. Every pending
+  // name has one entry in a min-heap of deadlines. A later event only moves
+  // its deadline in due_, never earlier, so an entry that comes up early is
+  // pushed back with the current deadline instead of being taken.
+  class pending_files
+  {
+  public:
+    explicit pending_files(const std::chrono::milliseconds debounce)
+        : debounce_{debounce}
+    {}
+
+    auto arrived(std::string name, const clock::time_point now) -> void
+    {
+      const auto deadline{now + debounce_};
+      if ( due_.insert_or_assign(name, deadline).second )
+        push(deadline, std::move(name));
+    }
+
+    auto touched(const std::string& name, const clock::time_point now) -> void
+    {
+      if ( const auto found{due_.find(name)}; found != due_.end() )
+        found->second = now + debounce_;
+    }
+
+    // poll() timeout in milliseconds: -1 sleeps until the next event. The
+    // earliest entry may wake it before its file is due, never after.
+    [[nodiscard]] auto timeout(const clock::time_point now) const -> int
+    {
+      if ( heap_.empty() )
+        return -1;
+
+      using std::chrono::milliseconds;
+
+      const auto next{heap_.front().first};
+      const auto wait{std::chrono::ceil<milliseconds>(next - now).count()};
+      return static_cast<int>(std::max<milliseconds::rep>(0, wait));
+    }
+
+    [[nodiscard]] auto take_due(
+                const fs::path&          root,
+                const clock::time_point  now,
+                const std::size_t        limit
+    ) -> std::vector<fs::path>
+    {
+      auto ready{std::vector<fs::path>{}};
+
+      while ( not heap_.empty() and heap_.front().first <= now
+              and ready.size() < limit )
+      {
+        std::ranges::pop_heap(heap_, std::greater{});
+        auto name{std::move(heap_.back().second)};
+        heap_.pop_back();
+
+        const auto found{due_.find(name)};
+        if ( found->second > now )
+        {
+          push(found->second, std::move(name));
+          continue;
+        }
+
+        due_.erase(found);
+        ready.push_back(root / name);
+      }
+
+      return ready;
+    }
+
+  private:
+    // Earliest deadline at the front
+    using deadline_entry = std::pair<clock::time_point, std::string>;
+
+    auto push(const clock::time_point deadline, std::string name) -> void
+    {
+      heap_.emplace_back(deadline, std::move(name));
+      std::ranges::push_heap(heap_, std::greater{});
+    }
+
+    std::chrono::milliseconds                           debounce_;
+    std::unordered_map<std::string, clock::time_point> due_{};
+    std::vector<deadline_entry>                         heap_{};
+  };
+
+  auto queue_existing(const fs::path& root, pending_files& pending) -> void
+  {
+    const auto now{clock::now()};
+    for ( auto&& file : scanner::collect_files(root).file_bin )
+      pending.arrived(file.filename().string(), now);
+  }
+
+  // Drains the (non-blocking) inotify descriptor. Fails once the watched root
+  // itself is deleted or moved away.
+  auto read_events(
+              const int       inotify_fd,
+              const fs::path& root,
+              pending_files&  pending
+  ) -> VoidResult
+  {
+    alignas(inotify_event) auto buffer{std::array<char, event_buffer_size>{}};
+
+    while ( true )
+    {
+      const auto filled{::read(inotify_fd, buffer.data(), buffer.size())};
+      if ( filled < 0 )
+      {
+        if ( errno == EAGAIN or errno == EINTR )
+          return {};
+        return std::unexpected{last_error()};
+      }
+
+      const auto now{clock::now()};
+      const auto end{static_cast<std::size_t>(filled)};
+
+      for ( auto offset{std::size_t{0}}; offset < end; )
+      {
+        auto event{inotify_event{}};
+        std::memcpy(&event, buffer.data() + offset, sizeof(inotify_event));
+
+        // name is NUL-padded to event.len bytes
+        const auto* name_at{buffer.data() + offset + sizeof(inotify_event)};
+        const auto  name{event.len > 0 ? std::string{name_at} : std::string{}};
+        offset += sizeof(inotify_event) + event.len;
+
+        if ( (event.mask & (IN_DELETE_SELF | IN_MOVE_SELF)) != 0 )
+          return std::unexpected{
+                       std::make_error_code(std::errc::no_such_file_or_directory)
+          };
+
+        // The kernel dropped events; one listing recovers whatever they were
+        if ( (event.mask & IN_Q_OVERFLOW) != 0 )
+        {
+          queue_existing(root, pending);
+          continue;
+        }
+
+        if ( (event.mask & IN_ISDIR) != 0 or name.empty() )
+          continue;
+
+        if ( (event.mask & arrival_mask) != 0 )
+          pending.arrived(name, now);
+        else if ( (event.mask & IN_MODIFY) != 0 )
+          pending.touched(name, now);
+      }
+    }
+  }
+
+  // Files may have been removed or replaced while debouncing
+  auto still_regular(const fs::path& file) -> bool
+  {
+    const auto stamp{safe_fs::stamp(file, false)};
+    return stamp and stamp->type == safe_fs::entry_type::regular;
+  }
+
+  auto run_batch(
+              const fs::path&                  root,
+              const planner::planning_options& planning,
+              std::vector<fs::path>&&          files,
+              executor::execution_context&     context,
+              const batch_callback&            on_batch
+  ) -> void
+  {
+    std::erase_if(files, [](const fs::path& file) {
+      return not still_regular(file);
+    });
+    if ( files.empty() )
+      return;
+
+    const auto plan{
+         planner::generate_compact_plan(std::move(files), root, planning)
+    };
+    const auto report{executor::execute_plan(plan, context)};
+
+    // A failure may come from a cache gone stale (a bucket deleted behind our
+    // back); starting the next batch from a fresh context heals that
+    if ( report.failure_count() > 0 )
+      context = executor::execution_context{};
+
+    if ( on_batch )
+      on_batch(report);
+  }
+} // namespace
+#endif
+
+namespace fs_ops::watcher
+{
+#if defined(__linux__)
+  auto watch(
+              const fs::path&       root,
+              const watch_options&  options,
+              const std::stop_token stop,
+              const batch_callback& on_batch
+  ) -> VoidResult
+  {
+    const auto inotify{unique_fd{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}};
+    if ( not inotify.valid() )
+      return std::unexpected{last_error()};
+
+    const auto wake{unique_fd{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)}};
+    if ( not wake.valid() )
+      return std::unexpected{last_error()};
+
+    if ( ::inotify_add_watch(inotify.get(), root.c_str(), watch_mask) < 0 )
+      return std::unexpected{last_error()};
+
+    // Runs on whichever thread requests the stop and interrupts poll()
+    const auto on_stop{std::stop_callback{stop, [&wake] {
+      const auto one{std::uint64_t{1}};
+      [[maybe_unused]] const auto written{
+           ::write(wake.get(), &one, sizeof(one))
+      };
+    }}};
+
+    auto pending{pending_files{options.debounce}};
+    auto context{executor::execution_context{}};
+    const auto batch_limit{std::max<std::size_t>(1, options.max_batch)};
+
+    queue_existing(root, pending);
+
+    while ( not stop.stop_requested() )
+    {
+      auto fds{std::array<pollfd, 2>{{
+           {.fd = inotify.get(), .events = POLLIN, .revents = 0},
+           {.fd = wake.get(), .events = POLLIN, .revents = 0},
+      }}};
+
+      if ( ::poll(fds.data(), fds.size(), pending.timeout(clock::now())) < 0 )
+      {
+        if ( errno == EINTR )
+          continue;
+        return std::unexpected{last_error()};
+      }
+
+      if ( (fds[0].revents & POLLIN) != 0 )
+      {
+        if ( auto drained{read_events(inotify.get(), root, pending)};
+             not drained )
+          return drained;
+      }
+
+      while ( true )
+      {
+        auto due{pending.take_due(root, clock::now(), batch_limit)};
+        if ( due.empty() )
+          break;
+        run_batch(root, options.planning, std::move(due), context, on_batch);
+      }
+    }
+
+    return {};
+  }
+#else
+  auto watch(
+              const fs::path&,
+              const watch_options&,
+              const std::stop_token,
+              const batch_callback&
+  ) -> VoidResult
+  {
+    return std::unexpected{std::make_error_code(std::errc::not_supported)};
+  }
+#endif
+} // namespace fs_ops::watcher
@@ -0,0 +1,235 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF (before fmt to avoid conflicts)
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iterator>
+#include <new>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+module filejanitor;
+
+// NO import std; - conflicts with #include in GMF
+
+using namespace instrumentation;
+
+namespace
+{
+  constexpr auto relaxed{std::memory_order_relaxed};
+
+  constexpr auto counter_names{std::array<std::string_view, counter_count>{
+       "exists_calls",
+       "stat_calls",
+       "rename_calls",
+       "mkdir_calls",
+       "copy_calls",
+       "link_calls",
+       "collision_probes",
+  }};
+
+  constexpr auto phase_names{std::array<std::string_view, phase_count>{
+       "scan",
+       "plan",
+       "dedup",
+       "execute",
+  }};
+
+  struct phase_totals
+  {
+    std::atomic<std::uint64_t> wall_ns{0};
+    std::atomic<std::uint64_t> cpu_ns{0};
+    std::atomic<std::uint64_t> bytes_allocated{0};
+    std::atomic<std::uint64_t> allocations{0};
+  };
+
+  // Namespace-scope atomics are constant-initialized, so hooks (allocations
+  // above all) are safe to hit before main, during static initialization
+  std::array<std::atomic<std::uint64_t>, counter_count> counters{};
+  std::array<phase_totals, phase_count>                 phases{};
+  std::atomic<std::uint64_t>                            allocated_bytes{0};
+  std::atomic<std::uint64_t>                            allocation_count{0};
+
+  [[maybe_unused]] auto count_allocation(const std::size_t size) noexcept -> void
+  {
+    allocated_bytes.fetch_add(size, relaxed);
+    allocation_count.fetch_add(1, relaxed);
+  }
+
+  auto wall_now_ns() noexcept -> std::uint64_t
+  {
+    using std::chrono::nanoseconds;
+
+    const auto now{std::chrono::steady_clock::now().time_since_epoch()};
+    return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<nanoseconds>(now).count()
+    );
+  }
+
+  auto cpu_now_ns() noexcept -> std::uint64_t
+  {
+    const auto ticks{std::clock()};
+    if ( ticks < 0 )
+      return 0;
+
+    const auto seconds{static_cast<double>(ticks) / CLOCKS_PER_SEC};
+    return static_cast<std::uint64_t>(seconds * 1e9);
+  }
+
+  auto index_of(const auto value) noexcept -> std::size_t
+  {
+    return static_cast<std::size_t>(value);
+  }
+} // namespace
+
+namespace instrumentation::detail
+{
+  auto counter_slot(const counter which) noexcept -> std::atomic<std::uint64_t>&
+  {
+    return counters[index_of(which)];
+  }
+
+  auto sample() noexcept -> resource_sample
+  {
+    return {
+         .wall_ns{wall_now_ns()},
+         .cpu_ns{cpu_now_ns()},
+         .bytes_allocated{allocated_bytes.load(relaxed)},
+         .allocations{allocation_count.load(relaxed)},
+    };
+  }
+
+  auto add_phase(const phase which, const resource_sample& start) noexcept -> void
+  {
+    const auto end{sample()};
+    auto&      slot{phases[index_of(which)]};
+
+    slot.wall_ns.fetch_add(end.wall_ns - start.wall_ns, relaxed);
+    slot.cpu_ns.fetch_add(end.cpu_ns - start.cpu_ns, relaxed);
+    slot.bytes_allocated.fetch_add(
+                end.bytes_allocated - start.bytes_allocated,
+                relaxed
+    );
+    slot.allocations.fetch_add(end.allocations - start.allocations, relaxed);
+  }
+} // namespace instrumentation::detail
+
+namespace instrumentation
+{
+  auto counter_value(const counter which) noexcept -> std::uint64_t
+  {
+    return detail::counter_slot(which).load(relaxed);
+  }
+
+  auto totals(const phase which) noexcept -> phase_stats
+  {
+    const auto& slot{phases[index_of(which)]};
+    return {
+         .wall_ns{slot.wall_ns.load(relaxed)},
+         .cpu_ns{slot.cpu_ns.load(relaxed)},
+         .bytes_allocated{slot.bytes_allocated.load(relaxed)},
+         .allocations{slot.allocations.load(relaxed)},
+    };
+  }
+
+  auto allocations() noexcept -> std::uint64_t
+  {
+    return allocation_count.load(relaxed);
+  }
+
+  auto to_json() -> std::string
+  {
+    auto out{std::string{}};
+    auto sink{std::back_inserter(out)};
+
+    fmt::format_to(sink, R"({{"enabled":{},"phases":{{)", enabled);
+    for ( auto idx{std::size_t{0}}; idx < phase_count; ++idx )
+    {
+      const auto stats{totals(static_cast<phase>(idx))};
+      fmt::format_to(
+                  sink,
+                  R"({}"{}":{{"wall_ns":{},"cpu_ns":{},"bytes_allocated":{},)"
+                  R"("allocations":{}}})",
+                  idx == 0 ? "" : ",",
+                  phase_names[idx],
+                  stats.wall_ns,
+                  stats.cpu_ns,
+                  stats.bytes_allocated,
+                  stats.allocations
+      );
+    }
+
+    fmt::format_to(sink, R"(}},"counters":{{)");
+    for ( auto idx{std::size_t{0}}; idx < counter_count; ++idx )
+    {
+      fmt::format_to(
+                  sink,
+                  R"({}"{}":{})",
+                  idx == 0 ? "" : ",",
+                  counter_names[idx],
+                  counter_value(static_cast<counter>(idx))
+      );
+    }
+
+    out += "}}";
+    return out;
+  }
+} // namespace instrumentation
+
+// Replaceable global allocation functions (attached to the global module even
+// though they are defined here). Only replaced in instrumented builds.
+#if defined(FILEJANITOR_INSTRUMENTATION)
+auto operator new(const std::size_t size) -> void*
+{
+  count_allocation(size);
+  if ( auto* const memory{std::malloc(size == 0 ? 1 : size)} )
+    return memory;
+  throw std::bad_alloc{};
+}
+
+auto operator new(const std::size_t size, const std::align_val_t alignment)
+            -> void*
+{
+  count_allocation(size);
+
+  // aligned_alloc wants a size that is a multiple of the alignment
+  const auto align{static_cast<std::size_t>(alignment)};
+  const auto rounded{(std::max<std::size_t>(size, 1) + align - 1) / align * align};
+  if ( auto* const memory{std::aligned_alloc(align, rounded)} )
+    return memory;
+  throw std::bad_alloc{};
+}
+
+auto operator delete(void* const memory) noexcept -> void
+{
+  std::free(memory);
+}
+
+auto operator delete(void* const memory, std::size_t) noexcept -> void
+{
+  std::free(memory);
+}
+
+auto operator delete(void* const memory, std::align_val_t) noexcept -> void
+{
+  std::free(memory);
+}
+
+auto operator delete(void* const memory, std::size_t, std::align_val_t) noexcept
+            -> void
+{
+  std::free(memory);
+}
+#endif
@@ -1,10 +1,25 @@
 // Standard headers BEFORE fmt (fmt includes std headers internally)
+#include <cstddef>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stop_token>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <thread>
 #include <utility>
 #include <vector>
 
+#if defined(__unix__)
+#  include <csignal>
+#  include <pthread.h>
+#  include <unistd.h>
+#endif
+
 #include <fmt/ostream.h>
 
 import filejanitor;
@@ -14,11 +29,706 @@ using namespace std::string_literals;
 
 namespace fs = std::filesystem;
 
+using instrumentation::phase;
+using instrumentation::scoped_phase;
+
+namespace
+{
+  // Progress lines; quiet output keeps stdout silent apart from --stats -
+  template <typename... Args>
+  auto note(
+              const cli::options&         options,
+              fmt::format_string<Args...> format,
+              Args&&... args
+  ) -> void
+  {
+    if ( options.output != output::output_mode::quiet )
+    {
+      fmt::println(format, std::forward<Args>(args)...);
+    }
+  }
+
+  // The --ndjson log, when one was asked for and could be created
+  auto open_log(const cli::options& options) -> std::optional<output::ndjson_log>
+  {
+    if ( options.ndjson_file.empty() )
+    {
+      return std::nullopt;
+    }
+
+    auto log = output::ndjson_log::open(options.ndjson_file);
+
+    if ( not log )
+    {
+      fmt::println(stderr, "Cannot open NDJSON log: {}", log.error().message());
+      return std::nullopt;
+    }
+
+    return std::move(*log);
+  }
+
+  auto report_results(
+              const cli::options&                       options,
+              std::optional<output::ndjson_log>&        log,
+              const fs_ops::executor::execution_report& report
+  ) -> void
+  {
+    output::print_report(report, options.output);
+
+    if ( log )
+    {
+      log->write_report(report);
+    }
+
+    if ( options.report_file.empty() )
+    {
+      return;
+    }
+
+    const auto saved =
+                fs_ops::executor::write_report_file(report, options.report_file);
+
+    if ( not saved )
+    {
+      fmt::println(stderr, "Cannot save report: {}", saved.error().message());
+    }
+  }
+
+  // --dry-run: every final name is resolved, nothing on disk changes
+  template <typename Plan>
+  auto report_dry_run(
+              const cli::options&                options,
+              std::optional<output::ndjson_log>& log,
+              const Plan&                        plan
+  ) -> void
+  {
+    note(options, "\n--- DRY RUN: NOTHING WILL BE MOVED ---");
+
+    const auto result = [&] {
+      const auto timed = scoped_phase{phase::execute};
+      return fs_ops::executor::dry_run(plan, options.execution);
+    }();
+
+    output::print_resolved(result.resolved, options.output);
+    report_results(options, log, result.report);
+  }
+
+  auto hash_duplicates(const cli::options& options, const fs_ops::compact_plan& plan)
+              -> fs_ops::dedup::duplicate_set
+  {
+    note(options, "\n--- DEDUP: HASHING FILES THAT SHARE A SIZE ---");
+
+    auto found = [&] {
+      const auto timed = scoped_phase{phase::dedup};
+      return fs_ops::dedup::find_duplicates(plan, options.dedup);
+    }();
+
+    note(
+                options,
+                "Hashed {} files ({} bytes): {} duplicates, {} bytes reclaimable.",
+                found.files_hashed,
+                found.bytes_hashed,
+                found.duplicates.size(),
+                found.duplicate_bytes
+    );
+
+    return found;
+  }
+
+  auto replace_with_links(
+              const cli::options&                 options,
+              const fs_ops::compact_plan&         plan,
+              const fs_ops::dedup::duplicate_set& duplicates
+  ) -> void
+  {
+    const auto report = [&] {
+      const auto timed = scoped_phase{phase::dedup};
+      return fs_ops::dedup::link_duplicates(plan, duplicates);
+    }();
+
+    note(options, "Replaced {} duplicates with hard links.", report.success_count());
+
+    for ( const auto& [source, original, error] : report.failures() )
+    {
+      fmt::println(
+                  stderr,
+                  "  - Cannot link '{}' to '{}': {}",
+                  source.string(),
+                  original.string(),
+                  error.message()
+      );
+    }
+  }
+
+  // Writes the instrumentation JSON when main returns, whichever path it takes.
+  // Counters stay zero ("enabled": false) unless the build is instrumented.
+  class stats_writer
+  {
+  public:
+    explicit stats_writer(fs::path file)
+        : file_{std::move(file)}
+    {}
+
+    stats_writer(const stats_writer&)                    = delete;
+    auto operator=(const stats_writer&) -> stats_writer& = delete;
+
+    ~stats_writer()
+    {
+      if ( file_.empty() )
+      {
+        return;
+      }
+
+      if ( file_ == "-" )
+      {
+        fmt::println("{}", instrumentation::to_json());
+        return;
+      }
+
+      auto out = std::ofstream{file_, std::ios::trunc};
+      out << instrumentation::to_json() << '\n';
+
+      if ( not out )
+      {
+        fmt::println(stderr, "Cannot write stats to {}", file_.string());
+      }
+    }
+
+  private:
+    fs::path file_;
+  };
+
+  // One parsed rule set, shared by every planner the run may use
+  auto load_rules(cli::options& options) -> bool
+  {
+    if ( options.rules_file.empty() )
+    {
+      return true;
+    }
+
+    auto rules = fs_ops::rules::rule_set::load(options.rules_file);
+    if ( not rules )
+    {
+      fmt::println(stderr, "Cannot load rules: {}", rules.error().message());
+      return false;
+    }
+
+    const auto shared =
+                std::make_shared<const fs_ops::rules::rule_set>(std::move(*rules));
+
+    options.planning.rules          = shared;
+    options.pipeline.planning.rules = shared;
+    options.watch.planning.rules    = shared;
+    return true;
+  }
+
+  // Dedup, size rules and cross-device moves each need every file's size, so
+  // the scan answers it once instead of each phase taking its own stat. Saved
+  // plans keep each source's device and inode, the only thing a journal's
+  // recovery can tell a moved file by.
+  auto wants_metadata(const cli::options& options) -> bool
+  {
+    const auto& rules = options.planning.rules;
+    return options.deduplicating or options.execution.cross_device
+           or (rules and rules->has_size_rules())
+           or not options.journal_file.empty() or not options.write_plan.empty();
+  }
+
+  // The execute phase, run as coroutines on an event loop under --async
+  template <typename Plan>
+  auto run_execution(
+              const cli::options&                        options,
+              const Plan&                                plan,
+              const fs_ops::executor::execution_options& execution
+  ) -> fs_ops::executor::execution_report
+  {
+    const auto timed = scoped_phase{phase::execute};
+
+    if ( not options.async_execution )
+    {
+      return fs_ops::executor::execute_plan(plan, execution);
+    }
+
+    auto loop = fs_ops::async::io_loop{options.loop};
+    return loop.run(fs_ops::executor::execute_plan(plan, execution, loop));
+  }
+
+  // Executes a mapped plan with every completed move appended to journal,
+  // which is synced once more before the report goes out
+  auto execute_journaled(
+              const cli::options&              options,
+              const fs_ops::mapped_plan&       plan,
+              fs_ops::journal::journal_writer& journal
+  ) -> fs_ops::executor::execution_report
+  {
+    auto execution    = options.execution;
+    execution.journal = &journal;
+
+    auto report = run_execution(options, plan, execution);
+
+    if ( const auto synced = journal.sync(); not synced )
+    {
+      fmt::println(stderr, "Journal is incomplete: {}", synced.error().message());
+    }
+
+    return report;
+  }
+
+  auto start_journal(
+              const cli::options&        options,
+              const fs::path&            plan_file,
+              const fs_ops::mapped_plan& plan
+  ) -> std::optional<fs_ops::journal::journal_writer>
+  {
+    auto journal = fs_ops::journal::journal_writer::create(
+                options.journal_file,
+                plan_file,
+                plan
+    );
+
+    if ( not journal )
+    {
+      fmt::println(stderr, "Cannot start journal: {}", journal.error().message());
+      return std::nullopt;
+    }
+
+    return std::move(*journal);
+  }
+
+  // The journal and the plan it indexes, refusing a plan that changed since
+  auto load_journal(const fs::path& file)
+              -> std::optional<std::pair<fs_ops::journal::journal_contents,
+                                         fs_ops::mapped_plan>>
+  {
+    auto contents = fs_ops::journal::read_journal(file);
+
+    if ( not contents )
+    {
+      fmt::println(stderr, "Cannot read journal: {}", contents.error().message());
+      return std::nullopt;
+    }
+
+    auto plan = fs_ops::journal::open_plan(*contents);
+
+    if ( not plan )
+    {
+      fmt::println(
+                  stderr,
+                  "Cannot load journaled plan {}: {}",
+                  contents->plan_file.string(),
+                  plan.error().message()
+      );
+      return std::nullopt;
+    }
+
+    return std::pair{std::move(*contents), std::move(*plan)};
+  }
+
+  // Moves a killed run made after its last journal write
+  auto recover_unjournaled(
+              const cli::options&                options,
+              fs_ops::journal::journal_contents& contents,
+              const fs_ops::mapped_plan&         plan
+  ) -> void
+  {
+    const auto recovered = fs_ops::journal::reconcile(contents, plan);
+    if ( recovered > 0 )
+    {
+      note(options, "Found {} moves the journal had not recorded yet.", recovered);
+    }
+  }
+
+  auto run_resume(const cli::options& options) -> int
+  {
+    const auto& file = options.journal_file;
+
+    note(options, "--- RESUMING FROM JOURNAL: {} ---", file.string());
+    auto loaded = load_journal(file);
+
+    if ( not loaded )
+    {
+      return 1;
+    }
+
+    auto& [contents, plan] = *loaded;
+    recover_unjournaled(options, contents, plan);
+
+    auto journal = fs_ops::journal::journal_writer::resume(file, contents);
+
+    if ( not journal )
+    {
+      fmt::println(stderr, "Cannot reopen journal: {}", journal.error().message());
+      return 1;
+    }
+
+    note(
+                options,
+                "{} of {} operations were already done.",
+                journal->resumed_count(),
+                plan.size()
+    );
+
+    auto       log    = open_log(options);
+    const auto report = execute_journaled(options, plan, *journal);
+
+    report_results(options, log, report);
+    return 0;
+  }
+
+  // A fully undone journal is removed, so it cannot be replayed twice
+  auto run_undo(const cli::options& options) -> int
+  {
+    const auto& file = options.journal_file;
+
+    note(options, "--- UNDOING JOURNAL: {} ---", file.string());
+    auto loaded = load_journal(file);
+
+    if ( not loaded )
+    {
+      return 1;
+    }
+
+    auto& [contents, plan] = *loaded;
+    recover_unjournaled(options, contents, plan);
+    note(options, "Moving {} files back.", contents.entries.size());
+
+    const auto report = [&] {
+      const auto timed = scoped_phase{phase::execute};
+      return fs_ops::journal::undo(contents, plan);
+    }();
+
+    auto log = open_log(options);
+    report_results(options, log, report);
+
+    if ( report.failure_count() == 0 )
+    {
+      if ( const auto removed = safe_fs::remove(file); not removed )
+      {
+        fmt::println(stderr, "Cannot remove journal: {}", removed.error().message());
+      }
+    }
+
+    return 0;
+  }
+
+  auto run_saved_plan(const cli::options& options) -> int
+  {
+    const auto& file = options.execute_plan;
+
+    note(options, "--- EXECUTING SAVED PLAN: {} ---", file.string());
+    const auto plan = fs_ops::mapped_plan::open(file);
+
+    if ( not plan )
+    {
+      fmt::println(stderr, "Cannot load plan: {}", plan.error().message());
+      return 1;
+    }
+
+    note(options, "Loaded {} operations.", plan->size());
+
+    auto log = open_log(options);
+
+    if ( options.dry_run )
+    {
+      report_dry_run(options, log, *plan);
+      return 0;
+    }
+
+    if ( not options.journal_file.empty() )
+    {
+      auto journal = start_journal(options, file, *plan);
+
+      if ( not journal )
+      {
+        return 1;
+      }
+
+      report_results(options, log, execute_journaled(options, *plan, *journal));
+      return 0;
+    }
+
+    const auto report = run_execution(options, *plan, options.execution);
+
+    report_results(options, log, report);
+    return 0;
+  }
+
+  // A journaled run executes its plan from a file beside the journal, so a
+  // resume finds exactly the same operations again
+  auto execute_fresh(const cli::options& options, const fs_ops::compact_plan& plan)
+              -> std::optional<fs_ops::executor::execution_report>
+  {
+    if ( options.journal_file.empty() )
+    {
+      return run_execution(options, plan, options.execution);
+    }
+
+    auto plan_file = options.journal_file;
+    plan_file += ".plan";
+
+    if ( const auto saved = fs_ops::write_plan_file(plan, plan_file); not saved )
+    {
+      fmt::println(stderr, "Cannot write plan: {}", saved.error().message());
+      return std::nullopt;
+    }
+
+    const auto mapped = fs_ops::mapped_plan::open(plan_file);
+
+    if ( not mapped )
+    {
+      fmt::println(stderr, "Cannot load plan: {}", mapped.error().message());
+      return std::nullopt;
+    }
+
+    auto journal = start_journal(options, plan_file, *mapped);
+
+    if ( not journal )
+    {
+      return std::nullopt;
+    }
+
+    return execute_journaled(options, *mapped, *journal);
+  }
+
+  // --merge-report: one report out of those that separate runs saved
+  auto run_merge(const cli::options& options) -> int
+  {
+    note(options, "--- MERGING {} REPORTS ---", options.merge_reports.size());
+    const auto merged = fs_ops::executor::merge_report_files(options.merge_reports);
+
+    if ( not merged )
+    {
+      fmt::println(stderr, "Cannot merge reports: {}", merged.error().message());
+      return 1;
+    }
+
+    auto log = open_log(options);
+    report_results(options, log, *merged);
+    return 0;
+  }
+
+  // Every root given on the command line or in --manifest, organized as a job
+  // of its own; the roots that could be organized are reported as one run
+  auto run_many_roots(const cli::options& options) -> int
+  {
+    auto roots = options.roots;
+
+    if ( not options.manifest_file.empty() )
+    {
+      auto listed = fs_ops::multi_root::read_manifest(options.manifest_file);
+
+      if ( not listed )
+      {
+        fmt::println(stderr, "Cannot read manifest: {}", listed.error().message());
+        return 1;
+      }
+
+      roots.insert(
+                  roots.end(),
+                  std::make_move_iterator(listed->begin()),
+                  std::make_move_iterator(listed->end())
+      );
+    }
+
+    note(options, "--- ORGANIZING {} ROOTS ---", roots.size());
+
+    auto results = fs_ops::multi_root::run_roots(
+                roots,
+                {
+                     .worker_count = options.root_workers,
+                     .scan         = options.scan,
+                     .planning     = options.planning,
+                     .execution    = options.execution,
+                }
+    );
+
+    auto merged   = fs_ops::executor::execution_report::start();
+    auto complete = true;
+
+    for ( auto& result : results )
+    {
+      if ( result.error )
+      {
+        fmt::println(
+                    stderr,
+                    "Cannot organize {}: {}",
+                    result.root.string(),
+                    result.error.message()
+        );
+        complete = false;
+        continue;
+      }
+
+      note(
+                  options,
+                  "{}: {} files, {} scan errors, {} moved, {} failed.",
+                  result.root.string(),
+                  result.files_scanned,
+                  result.scan_errors,
+                  result.report.success_count(),
+                  result.report.failure_count()
+      );
+      merged = std::move(merged).with_report(std::move(result.report)).finalize();
+    }
+
+    auto log = open_log(options);
+    report_results(options, log, merged);
+    return complete ? 0 : 1;
+  }
+
+  // An index that is missing or unreadable just means a full scan this time
+  auto load_index(const fs::path& file) -> std::optional<fs_ops::scanner::scan_index>
+  {
+    if ( file.empty() )
+    {
+      return std::nullopt;
+    }
+
+    auto loaded = fs_ops::scanner::scan_index::load(file);
+
+    if ( not loaded and loaded.error() != std::errc::no_such_file_or_directory )
+    {
+      fmt::println(stderr, "Ignoring scan index: {}", loaded.error().message());
+    }
+
+    return std::move(loaded).value_or(fs_ops::scanner::scan_index{});
+  }
+
+  auto save_index(const fs_ops::scanner::scan_index& index, const fs::path& file)
+              -> void
+  {
+    if ( const auto saved = index.save(file); not saved )
+    {
+      fmt::println(stderr, "Cannot save scan index: {}", saved.error().message());
+    }
+  }
+
+  auto run_pipelined(const fs::path& root, const cli::options& options) -> int
+  {
+    note(options, "--- STREAMING: SCAN -> PLAN -> EXECUTE ---");
+    const auto result = fs_ops::pipeline::run_pipeline(root, options.pipeline);
+
+    note(options, "Found {} files.", result.files_scanned);
+
+    if ( result.scan_errors > 0 )
+    {
+      note(options, "Encountered {} errors during scan.", result.scan_errors);
+    }
+
+    auto log = open_log(options);
+    report_results(options, log, result.report);
+    return 0;
+  }
+
+  // Stops on SIGINT/SIGTERM: both are blocked before the watcher thread starts
+  // (so it inherits the mask) and this thread picks them up with sigwait
+  auto run_watch(const fs::path& root, const cli::options& options) -> int
+  {
+    note(options, "--- WATCHING: {} (Ctrl+C to stop) ---", root.string());
+
+#if defined(__unix__)
+    auto signals = sigset_t{};
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+#endif
+
+    auto log      = open_log(options);
+    auto on_batch = [&](const fs_ops::executor::execution_report& report) {
+      report_results(options, log, report);
+    };
+    auto result   = VoidResult{};
+    auto watcher  = std::jthread{[&](const std::stop_token stop) {
+      result = fs_ops::watcher::watch(root, options.watch, stop, on_batch);
+
+#if defined(__unix__)
+      // The watch ended on its own (an error); wake the waiting main thread
+      if ( not stop.stop_requested() )
+      {
+        ::kill(::getpid(), SIGTERM);
+      }
+#endif
+    }};
+
+#if defined(__unix__)
+    auto received = 0;
+    sigwait(&signals, &received);
+    watcher.request_stop();
+#endif
+
+    watcher.join();
+
+    if ( not result )
+    {
+      fmt::println(stderr, "Watch stopped: {}", result.error().message());
+      return 1;
+    }
+
+    return 0;
+  }
+} // namespace
+
 auto main(const int argc, char* argv[]) -> int
 {
-  // Default to current directory if no arg provided, or use the first argument
-  const auto raw_path       = (argc > 1) ? std::string_view{argv[1]} : "."sv;
-  const auto test_directory = fs::absolute(raw_path);
+  // Default to current directory if no directory is given on the command line
+  auto parsed = cli::parse_arguments(
+              std::span{argv, static_cast<std::size_t>(argc)}.subspan(1)
+  );
+
+  if ( not parsed )
+  {
+    fmt::print(stderr, "{}", cli::usage());
+    return 1;
+  }
+
+  if ( not load_rules(*parsed) )
+  {
+    return 1;
+  }
+
+  // Scan, plan and execute bookkeeping comes out of one arena, released in one
+  // go at exit. Watch and pipeline runs keep planning on the heap: they are
+  // long-lived, and a monotonic arena would only ever grow.
+  auto arena = fs_ops::arena::run_arena{};
+
+  parsed->scan.memory      = &arena;
+  parsed->planning.memory  = &arena;
+  parsed->execution.memory = &arena;
+
+  parsed->scan.collect_metadata = wants_metadata(*parsed);
+
+  const auto& options        = *parsed;
+  const auto  test_directory = fs::absolute(options.root);
+  const auto  stats          = stats_writer{options.stats_file};
+
+  // Saved reports only need reading
+  if ( not options.merge_reports.empty() )
+  {
+    return run_merge(options);
+  }
+
+  // A journal names the plan it belongs to
+  if ( options.undoing )
+  {
+    return run_undo(options);
+  }
+
+  if ( options.resuming )
+  {
+    return run_resume(options);
+  }
+
+  // A saved plan carries its own root
+  if ( not options.execute_plan.empty() )
+  {
+    return run_saved_plan(options);
+  }
+
+  if ( not options.roots.empty() or not options.manifest_file.empty() )
+  {
+    return run_many_roots(options);
+  }
 
   if ( !fs::exists(test_directory) )
   {
@@ -26,64 +736,128 @@ auto main(const int argc, char* argv[]) -> int
     return 1;
   }
 
+  if ( options.watching )
+  {
+    return run_watch(test_directory, options);
+  }
+
+  // Dry runs and dedup need the whole plan at once, so neither streams
+  if ( options.pipelined and not options.dry_run and not options.deduplicating )
+  {
+    return run_pipelined(test_directory, options);
+  }
+
   // --- PHASE 1: COLLECT ---
-  fmt::println("--- PHASE 1: SCANNING ---");
-  auto [files, errors] = fs_ops::scanner::collect_files(test_directory);
+  note(options, "--- PHASE 1: SCANNING ---");
+  auto index = load_index(options.index_file);
+  auto [files, errors, metadata] = [&] {
+    const auto timed = scoped_phase{phase::scan};
+    return index ? index->rescan(test_directory, options.scan)
+                 : fs_ops::scanner::collect_files(test_directory, options.scan);
+  }();
 
-  fmt::println("Found {} files.", files.size());
+  note(options, "Found {} files.", files.size());
 
   if ( not errors.empty() )
   {
-    fmt::println("Encountered {} errors during scan.", errors.size());
+    note(options, "Encountered {} errors during scan.", errors.size());
   }
 
   if ( files.empty() )
   {
-    fmt::println("No files to organize. Exiting.");
+    if ( index )
+    {
+      save_index(*index, options.index_file);
+    }
+
+    note(options, "No files to organize. Exiting.");
     return 0;
   }
 
   // --- PHASE 2: PLAN ---
-  fmt::println("\n--- PHASE 2: PLANNING ---");
-  const auto result =
-              fs_ops::planner::generate_plan(std::move(files), test_directory);
+  note(options, "\n--- PHASE 2: PLANNING ---");
+  auto plan = [&] {
+    const auto timed = scoped_phase{phase::plan};
+    return fs_ops::planner::generate_compact_plan(
+                std::move(files),
+                metadata,
+                test_directory,
+                options.planning
+    );
+  }();
 
-  fmt::println("Generated {} operations.", result.operations.size());
+  note(options, "Generated {} operations.", plan.size());
 
-  for ( const auto& [source, destination, bucket_name] : result.operations )
+  // --- DEDUP: duplicates drop out of the plan, or become links before executing
+  auto duplicates = fs_ops::dedup::duplicate_set{};
+
+  if ( options.deduplicating )
   {
-    fmt::println(
-                "[PLAN] {} -> {} (Bucket: {})",
-                source.filename().string(),
-                destination.string(),
-                bucket_name
-    );
+    duplicates = hash_duplicates(options, plan);
+
+    if ( options.dedup.action == fs_ops::dedup::duplicate_action::skip )
+    {
+      plan = fs_ops::dedup::without_duplicates(plan, duplicates);
+      note(options, "Left {} duplicates in place.", duplicates.duplicates.size());
+    }
+  }
+
+  output::print_plan(plan, options.output);
+
+  auto log = open_log(options);
+
+  if ( log )
+  {
+    log->write_plan(plan);
+  }
+
+  if ( not options.write_plan.empty() )
+  {
+    const auto saved = fs_ops::write_plan_file(plan, options.write_plan);
+    if ( not saved )
+    {
+      fmt::println(stderr, "Cannot write plan: {}", saved.error().message());
+      return 1;
+    }
+
+    note(options, "\nPlan saved to {}.", options.write_plan.string());
+    return 0;
+  }
+
+  if ( options.dry_run )
+  {
+    report_dry_run(options, log, plan);
+    return 0;
   }
 
   // --- PHASE 3: EXECUTE ---
   // In a real CLI, we would ask for confirmation here.
-  fmt::println("\n--- PHASE 3: EXECUTION ---");
+  note(options, "\n--- PHASE 3: EXECUTION ---");
+
+  if ( options.deduplicating
+       and options.dedup.action == fs_ops::dedup::duplicate_action::hard_link )
+  {
+    replace_with_links(options, plan, duplicates);
+  }
+
+  const auto report = execute_fresh(options, plan);
 
-  const auto report = fs_ops::executor::execute_plan(result);
+  if ( not report )
+  {
+    return 1;
+  }
 
-  fmt::println("Execution Complete.");
-  fmt::println("  Processed: {}", report.processed_count());
-  fmt::println("  Success:   {}", report.success_count());
-  fmt::println("  Failures:  {}", report.failure_count());
-  fmt::println("  Skipped:   {}", report.skipped_count());
+  report_results(options, log, *report);
 
-  if ( report.failure_count() > 0 )
+  // Files that failed to move are offered to the planner again next run
+  if ( index )
   {
-    fmt::println("\n[!] Errors:");
-    for ( const auto& [source, intended_destination, error] : report.failures() )
+    for ( const auto& failure : report->failures() )
     {
-      fmt::println(
-                  "  - Failed to move '{}' -> '{}': {}",
-                  source.filename().string(),
-                  intended_destination.string(),
-                  error.message()
-      );
+      index->forget(failure.source);
     }
+
+    save_index(*index, options.index_file);
   }
 
   return 0;
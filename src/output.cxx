@@ -0,0 +1,377 @@
+//
+// Created by Xavier on 10/14/2026.
+//
+
+module;
+
+// Standard headers in GMF (before fmt to avoid conflicts)
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <expected>
+#include <filesystem>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+module filejanitor;
+
+// NO import std; - conflicts with #include in GMF
+
+namespace fs = std::filesystem;
+
+using namespace output;
+
+namespace
+{
+  // Buffers are written out once they grow past this, so a million-line plan
+  // costs a few hundred writes instead of a million
+  constexpr std::size_t flush_threshold{1024UZ * 1024UZ};
+
+  // Lines a sampled listing shows at most
+  constexpr std::size_t sample_lines{20};
+
+  auto write_all(std::FILE* const file, const std::string_view text) -> void
+  {
+    [[maybe_unused]] const auto written{
+         std::fwrite(text.data(), 1, text.size(), file)
+    };
+  }
+
+  // Formats into one memory_buffer and hands it to file (stdout unless told
+  // otherwise) in large writes
+  class stream_writer
+  {
+  public:
+    explicit stream_writer(std::FILE* const file = stdout)
+        : file_{file}
+    {}
+
+    stream_writer(const stream_writer&)                    = delete;
+    auto operator=(const stream_writer&) -> stream_writer& = delete;
+
+    ~stream_writer() { flush(); }
+
+    template <typename... Args>
+    auto line(fmt::format_string<Args...> format, Args&&... args) -> void
+    {
+      const auto sink{std::back_inserter(buffer_)};
+      fmt::format_to(sink, format, std::forward<Args>(args)...);
+      buffer_.push_back('\n');
+
+      if ( buffer_.size() >= flush_threshold )
+        flush();
+    }
+
+    auto flush() -> void
+    {
+      write_all(file_, {buffer_.data(), buffer_.size()});
+      buffer_.clear();   // keeps the capacity for the next batch of lines
+    }
+
+  private:
+    std::FILE*         file_;
+    fmt::memory_buffer buffer_{};
+  };
+
+  // "root/bucket/" for every bucket, so a destination is prefix + filename
+  auto bucket_prefixes(const fs_ops::compact_plan& plan) -> std::vector<std::string>
+  {
+    auto prefixes{std::vector<std::string>{}};
+    prefixes.reserve(plan.bucket_count());
+
+    for ( auto bucket{std::uint32_t{0}}; bucket < plan.bucket_count(); ++bucket )
+      prefixes.push_back((plan.root() / plan.bucket_name(bucket) / "").string());
+
+    return prefixes;
+  }
+
+  auto source_prefixes(const fs_ops::compact_plan& plan) -> std::vector<std::string>
+  {
+    auto prefixes{std::vector<std::string>{}};
+    prefixes.reserve(plan.source_dir_count());
+
+    for ( auto dir{std::uint32_t{0}}; dir < plan.source_dir_count(); ++dir )
+      prefixes.push_back((plan.source_dir(dir) / "").string());
+
+    return prefixes;
+  }
+
+  // The indices a listing in this mode shows, as a stride over [0, count)
+  auto listing_stride(const std::size_t count, const output_mode mode) -> std::size_t
+  {
+    if ( mode == output_mode::full )
+      return 1;
+
+    return std::max<std::size_t>(1, (count + sample_lines - 1) / sample_lines);
+  }
+
+  auto shows_listing(const output_mode mode) -> bool
+  {
+    return mode == output_mode::full or mode == output_mode::sampled;
+  }
+
+  // JSON string contents: quotes, backslashes and control characters escaped
+  auto append_escaped(std::string& out, const std::string_view text) -> void
+  {
+    for ( const auto c : text )
+    {
+      switch ( c )
+      {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if ( static_cast<unsigned char>(c) < 0x20 )
+        {
+          const auto code{static_cast<int>(c)};
+          fmt::format_to(std::back_inserter(out), "\\u{:04x}", code);
+        }
+        else
+          out.push_back(c);
+      }
+    }
+  }
+
+  auto append_json_string(std::string& out, const std::string_view text) -> void
+  {
+    out.push_back('"');
+    append_escaped(out, text);
+    out.push_back('"');
+  }
+
+  // A path given as directory prefix + filename, without joining them first
+  auto append_json_path(
+              std::string&           out,
+              const std::string_view prefix,
+              const std::string_view name
+  ) -> void
+  {
+    out.push_back('"');
+    append_escaped(out, prefix);
+    append_escaped(out, name);
+    out.push_back('"');
+  }
+} // namespace
+
+namespace output
+{
+  auto print_plan(const fs_ops::compact_plan& plan, const output_mode mode) -> void
+  {
+    if ( not shows_listing(mode) or plan.empty() )
+      return;
+
+    const auto prefixes{bucket_prefixes(plan)};
+    const auto stride{listing_stride(plan.size(), mode)};
+    auto       out{stream_writer{}};
+
+    for ( auto idx{std::size_t{0}}; idx < plan.size(); idx += stride )
+    {
+      const auto bucket{plan.bucket_of(idx)};
+      const auto name{plan.filename(idx)};
+      out.line(
+                  "[PLAN] {} -> {}{} (Bucket: {})",
+                  name,
+                  prefixes[bucket],
+                  name,
+                  plan.bucket_name(bucket)
+      );
+    }
+
+    if ( stride > 1 )
+      out.line("[PLAN] ... sampled 1 in {} of {} operations", stride, plan.size());
+  }
+
+  auto print_resolved(const fs_ops::movement_plan& plan, const output_mode mode)
+              -> void
+  {
+    const auto& operations{plan.operations};
+    if ( not shows_listing(mode) or operations.empty() )
+      return;
+
+    const auto stride{listing_stride(operations.size(), mode)};
+    auto       out{stream_writer{}};
+
+    for ( auto idx{std::size_t{0}}; idx < operations.size(); idx += stride )
+    {
+      const auto& op{operations[idx]};
+      if ( op.source != op.destination )
+        out.line("[DRY RUN] {} -> {}", op.source.string(), op.destination.string());
+    }
+
+    if ( stride > 1 )
+      out.line(
+                  "[DRY RUN] ... sampled 1 in {} of {} operations",
+                  stride,
+                  operations.size()
+      );
+  }
+
+  auto print_report(
+              const fs_ops::executor::execution_report& report,
+              const output_mode                         mode
+  ) -> void
+  {
+    // Quiet still owes every failure, in full, since nothing else is printed
+    if ( mode == output_mode::quiet )
+    {
+      auto err{stream_writer{stderr}};
+      for ( const auto& [source, intended_destination, error] : report.failures() )
+      {
+        err.line(
+                    "Failed to move '{}' -> '{}': {}",
+                    source.string(),
+                    intended_destination.string(),
+                    error.message()
+        );
+      }
+      return;
+    }
+
+    auto out{stream_writer{}};
+    out.line("Execution Complete.");
+    out.line("  Processed: {}", report.processed_count());
+    out.line("  Success:   {}", report.success_count());
+    out.line("  Failures:  {}", report.failure_count());
+    out.line("  Skipped:   {}", report.skipped_count());
+
+    const auto failures{report.failures()};
+    if ( failures.empty() or not shows_listing(mode) )
+      return;
+
+    out.line("\n[!] Errors:");
+
+    const auto shown{mode == output_mode::full
+                     ? failures.size()
+                     : std::min(failures.size(), sample_lines)};
+    for ( const auto& [source, intended_destination, error] : failures.first(shown) )
+    {
+      out.line(
+                  "  - Failed to move '{}' -> '{}': {}",
+                  source.filename().string(),
+                  intended_destination.string(),
+                  error.message()
+      );
+    }
+
+    if ( shown < failures.size() )
+      out.line("  ... and {} more", failures.size() - shown);
+  }
+
+  ndjson_log::ndjson_log(std::FILE* const file) noexcept
+      : file_{file}
+  {}
+
+  ndjson_log::ndjson_log(ndjson_log&& other) noexcept
+      : file_{std::exchange(other.file_, nullptr)},
+        buffer_{std::move(other.buffer_)}
+  {}
+
+  auto ndjson_log::operator=(ndjson_log&& other) noexcept -> ndjson_log&
+  {
+    if ( this != &other )
+    {
+      flush();
+      if ( file_ )
+        std::fclose(file_);
+
+      file_   = std::exchange(other.file_, nullptr);
+      buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+  }
+
+  ndjson_log::~ndjson_log()
+  {
+    flush();
+    if ( file_ )
+      std::fclose(file_);
+  }
+
+  auto ndjson_log::open(const fs::path& file) -> Result<ndjson_log>
+  {
+    auto* const handle{std::fopen(file.c_str(), "w")};
+    if ( not handle )
+      return std::unexpected{std::error_code{errno, std::system_category()}};
+
+    return ndjson_log{handle};
+  }
+
+  auto ndjson_log::write_plan(const fs_ops::compact_plan& plan) -> void
+  {
+    const auto destinations{bucket_prefixes(plan)};
+    const auto sources{source_prefixes(plan)};
+
+    for ( auto idx{std::size_t{0}}; idx < plan.size(); ++idx )
+    {
+      const auto& record{plan.record(idx)};
+      const auto  name{plan.filename(idx)};
+
+      buffer_ += R"({"event":"plan","source":)";
+      append_json_path(buffer_, sources[record.source_dir], name);
+      buffer_ += R"(,"destination":)";
+      append_json_path(buffer_, destinations[record.bucket], name);
+      buffer_ += R"(,"bucket":)";
+      append_json_string(buffer_, plan.bucket_name(record.bucket));
+      buffer_ += "}\n";
+
+      flush_if_full();
+    }
+  }
+
+  auto ndjson_log::write_report(const fs_ops::executor::execution_report& report)
+              -> void
+  {
+    for ( const auto& [source, intended_destination, error] : report.failures() )
+    {
+      buffer_ += R"({"event":"failure","source":)";
+      append_json_string(buffer_, source.string());
+      buffer_ += R"(,"destination":)";
+      append_json_string(buffer_, intended_destination.string());
+      fmt::format_to(
+                  std::back_inserter(buffer_),
+                  R"(,"errno":{},"error":)",
+                  error.value()
+      );
+      append_json_string(buffer_, error.message());
+      buffer_ += "}\n";
+
+      flush_if_full();
+    }
+
+    fmt::format_to(
+                std::back_inserter(buffer_),
+                R"({{"event":"summary","processed":{},"success":{},"failures":{},)"
+                R"("skipped":{}}})"
+                "\n",
+                report.processed_count(),
+                report.success_count(),
+                report.failure_count(),
+                report.skipped_count()
+    );
+    flush();
+  }
+
+  auto ndjson_log::flush_if_full() -> void
+  {
+    if ( buffer_.size() >= flush_threshold )
+      flush();
+  }
+
+  auto ndjson_log::flush() -> void
+  {
+    if ( not file_ or buffer_.empty() )
+      return;
+
+    write_all(file_, buffer_);
+    buffer_.clear();
+  }
+} // namespace output
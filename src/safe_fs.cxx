@@ -5,10 +5,42 @@
 module;
 
 // Standard headers in GMF
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <expected>
 #include <filesystem>
+#include <fstream>
+#include <functional>
 #include <generator>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/stat.h>
+#endif
+
+#if defined(__linux__)
+#  include <dirent.h>
+#  include <fcntl.h>
+#  include <linux/fs.h>
+#  include <sys/ioctl.h>
+#  include <sys/sendfile.h>
+#  include <sys/syscall.h>
+#  include <sys/sysmacros.h>
+#  include <unistd.h>
+#endif
 
 module filejanitor;
 
@@ -16,11 +48,242 @@ module filejanitor;
 
 namespace fs = std::filesystem;
 
+namespace
+{
+#if defined(__unix__) || defined(__APPLE__)
+  // dev_t is already 64-bit unsigned on Linux, but signed on macOS
+  auto device_id(const dev_t device) noexcept -> std::uint64_t
+  {
+#  if defined(__APPLE__)
+    return static_cast<std::uint64_t>(device);
+#  else
+    return device;
+#  endif
+  }
+
+  auto type_of_mode(const mode_t mode) noexcept -> safe_fs::entry_type
+  {
+    using enum safe_fs::entry_type;
+
+    return S_ISREG(mode)   ? regular
+           : S_ISDIR(mode) ? directory
+           : S_ISLNK(mode) ? symlink
+                           : other;
+  }
+#endif
+
+#if defined(__linux__)
+  auto last_error() -> std::error_code
+  {
+    return {errno, std::system_category()};
+  }
+
+  // Layout of struct linux_dirent64, which glibc does not declare. Fields are
+  // read with memcpy since records are only 8-byte aligned at their start.
+  struct dirent64_layout
+  {
+    static constexpr std::size_t inode_offset{0};
+    static constexpr std::size_t reclen_offset{16};
+    static constexpr std::size_t type_offset{18};
+    static constexpr std::size_t name_offset{19};
+  };
+
+  // 64 KiB holds on the order of two thousand typical entries per syscall
+  constexpr std::size_t native_scan_buffer_size{64UZ * 1024UZ};
+
+  // Upper bound of one in-kernel copy call, so signals are seen between calls
+  constexpr std::size_t copy_chunk_size{1024UZ * 1024UZ * 1024UZ};
+
+  // Moves size bytes from in to out without them passing through user space:
+  // a reflink shares the extents outright (btrfs, XFS, ...); otherwise
+  // copy_file_range, and sendfile where that is refused (kernels before 5.3
+  // between filesystems, or before 4.5 at all)
+  auto transfer_bytes(const int in, const int out, std::size_t size) -> VoidResult
+  {
+    if ( ::ioctl(out, FICLONE, in) == 0 )
+      return {};
+
+    auto use_sendfile{false};
+    while ( size > 0 )
+    {
+      const auto chunk{std::min(size, copy_chunk_size)};
+      const auto sent{
+           use_sendfile ? ::sendfile(out, in, nullptr, chunk)
+                        : ::copy_file_range(in, nullptr, out, nullptr, chunk, 0)
+      };
+
+      if ( sent < 0 )
+      {
+        const auto refused{errno == EXDEV or errno == ENOSYS or errno == EINVAL
+                           or errno == EOPNOTSUPP};
+        if ( errno == EINTR )
+          continue;
+        if ( refused and not use_sendfile )
+        {
+          // Both calls advance the file offsets, so sendfile resumes in place
+          use_sendfile = true;
+          continue;
+        }
+        return std::unexpected{last_error()};
+      }
+
+      // The source shrank while it was copied; copy_file finds the short target
+      if ( sent == 0 )
+        break;
+
+      size -= static_cast<std::size_t>(sent);
+    }
+
+    return {};
+  }
+
+  // Fills buffer unless the file ends first; returns how much it holds
+  auto read_full(const int fd, const std::span<std::byte> buffer)
+              -> Result<std::size_t>
+  {
+    auto filled{std::size_t{0}};
+    while ( filled < buffer.size() )
+    {
+      const auto got{::read(fd, buffer.data() + filled, buffer.size() - filled)};
+      if ( got < 0 and errno == EINTR )
+        continue;
+      if ( got < 0 )
+        return std::unexpected{last_error()};
+      if ( got == 0 )
+        break;
+
+      filled += static_cast<std::size_t>(got);
+    }
+
+    return filled;
+  }
+
+  // Makes an entry just created in dir survive a crash
+  auto sync_directory(const fs::path& dir) -> VoidResult
+  {
+    const auto fd{::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+    if ( fd < 0 )
+      return std::unexpected{last_error()};
+
+    auto synced{::fsync(fd) == 0 ? VoidResult{} : std::unexpected{last_error()}};
+    ::close(fd);
+    return synced;
+  }
+
+  auto same_version(const struct stat& before, const struct stat& after) noexcept
+              -> bool
+  {
+    return before.st_size == after.st_size
+           and before.st_mtim.tv_sec == after.st_mtim.tv_sec
+           and before.st_mtim.tv_nsec == after.st_mtim.tv_nsec;
+  }
+
+  // The copy is complete only if it holds as many bytes as the source, and the
+  // source is still the version it started from. Anything else fails as
+  // resource_unavailable_try_again: the source is kept, and a later run can
+  // copy it once it has settled.
+  auto verify_copy(const int in, const int out, const struct stat& before)
+              -> VoidResult
+  {
+    struct stat source{};
+    struct stat target{};
+    if ( ::fstat(in, &source) != 0 or ::fstat(out, &target) != 0 )
+      return std::unexpected{last_error()};
+
+    if ( not same_version(before, source) or target.st_size != source.st_size )
+      return std::unexpected{
+                   std::make_error_code(std::errc::resource_unavailable_try_again)
+      };
+
+    return {};
+  }
+
+  auto to_entry_type(const unsigned char d_type) noexcept -> safe_fs::entry_type
+  {
+    using enum safe_fs::entry_type;
+
+    switch ( d_type )
+    {
+    case DT_REG:     return regular;
+    case DT_DIR:     return directory;
+    case DT_LNK:     return symlink;
+    case DT_UNKNOWN: return unknown;
+    default:         return other;
+    }
+  }
+
+  template <typename T>
+  auto read_field(const char* record, const std::size_t offset) noexcept -> T
+  {
+    auto value{T{}};
+    std::memcpy(&value, record + offset, sizeof(T));
+    return value;
+  }
+
+  auto is_dot_or_dot_dot(const std::string_view name) noexcept -> bool
+  {
+    return name == "." or name == "..";
+  }
+#else
+  auto to_entry_type(const fs::file_status status) noexcept -> safe_fs::entry_type
+  {
+    using enum safe_fs::entry_type;
+
+    switch ( status.type() )
+    {
+    case fs::file_type::regular:   return regular;
+    case fs::file_type::directory: return directory;
+    case fs::file_type::symlink:   return symlink;
+    case fs::file_type::none:
+    case fs::file_type::unknown:   return unknown;
+    default:                       return other;
+    }
+  }
+#endif
+} // namespace
+
 namespace safe_fs
 {
-  auto safe_scan(const fs::path path) -> std::generator<ScanResult>
+  directory_handle::directory_handle(const int fd) noexcept
+      : fd_{fd}
+  {}
+
+  directory_handle::directory_handle(directory_handle&& other) noexcept
+      : fd_{std::exchange(other.fd_, -1)}
+  {}
+
+  auto directory_handle::operator=(directory_handle&& other) noexcept
+              -> directory_handle&
+  {
+    std::swap(fd_, other.fd_);
+    return *this;
+  }
+
+  directory_handle::~directory_handle()
+  {
+#if defined(__linux__)
+    if ( fd_ >= 0 )
+      ::close(fd_);
+#endif
+  }
+
+  auto directory_handle::open(const fs::path& path) -> Result<directory_handle>
+  {
+#if defined(__linux__)
+    const auto fd{::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+    return fd >= 0 ? Result<directory_handle>{directory_handle{fd}}
+                   : std::unexpected{last_error()};
+#else
+    return std::unexpected{std::make_error_code(std::errc::not_supported)};
+#endif
+  }
+
+  auto directory_handle::native() const noexcept -> int { return fd_; }
+
+  auto safe_scan(const fs::path path) -> std::generator<const ScanResult&>
   {
     auto ec{std::error_code{}};
+    auto current{ScanResult{}};
 
     auto dir_it{fs::directory_iterator(path, ec)};
 
@@ -39,12 +302,224 @@ namespace safe_fs
         co_return;
       }
 
-      co_yield *dir_it;
+      current = *dir_it;
+      co_yield current;
+    }
+  }
+
+#if defined(_WIN32)
+  // Native paths are wide, the names narrow: each one is converted on append
+  auto join(const fs::path& dir, const std::initializer_list<std::string_view> names)
+              -> fs::path
+  {
+    auto joined{dir};
+    for ( const auto name : names )
+      joined /= name;
+    return joined;
+  }
+#else
+  auto join(const fs::path& dir, const std::initializer_list<std::string_view> names)
+              -> fs::path
+  {
+    const auto& base{dir.native()};
+
+    auto size{base.size()};
+    for ( const auto name : names )
+      size += name.size() + 1;
+
+    auto text{std::string{}};
+    text.reserve(size);
+    text.append(base);
+
+    // Names are single components; a separator goes between parts unless the
+    // text is still empty or already ends in one, as with operator/
+    for ( const auto name : names )
+    {
+      if ( not text.empty() and text.back() != '/' )
+        text.push_back('/');
+      text.append(name);
+    }
+
+    return fs::path{std::move(text)};
+  }
+#endif
+
+#if defined(__linux__)
+  auto native_scan(const fs::path path) -> std::generator<DirentResult>
+  {
+    const auto dir{directory_handle::open(path)};
+    if ( not dir )
+    {
+      co_yield std::unexpected{dir.error()};
+      co_return;
+    }
+
+    auto buffer{std::vector<char>(native_scan_buffer_size)};
+
+    while ( true )
+    {
+      const auto filled{
+           ::syscall(SYS_getdents64, dir->native(), buffer.data(), buffer.size())
+      };
+
+      if ( filled < 0 )
+      {
+        co_yield std::unexpected{last_error()};
+        co_return;
+      }
+
+      if ( filled == 0 )
+        co_return;
+
+      const auto end{static_cast<std::size_t>(filled)};
+      for ( auto offset{std::size_t{0}}; offset < end; )
+      {
+        const auto* record{buffer.data() + offset};
+        offset += read_field<std::uint16_t>(record, dirent64_layout::reclen_offset);
+
+        // d_name is NUL-terminated inside the record
+        const auto name{std::string_view{record + dirent64_layout::name_offset}};
+        if ( is_dot_or_dot_dot(name) )
+          continue;
+
+        co_yield dirent_view{
+             .name{name},
+             .type{to_entry_type(read_field<unsigned char>(
+                        record,
+                        dirent64_layout::type_offset
+             ))},
+             .inode{read_field<std::uint64_t>(record, dirent64_layout::inode_offset)}
+        };
+      }
     }
   }
+#else
+  auto native_scan(const fs::path path) -> std::generator<DirentResult>
+  {
+    for ( auto&& result : safe_scan(path) )
+    {
+      if ( not result )
+      {
+        co_yield std::unexpected{result.error()};
+        continue;
+      }
+
+      auto ec{std::error_code{}};
+      const auto name{result->path().filename().string()};
+      co_yield dirent_view{
+           .name{name},
+           .type{to_entry_type(result->symlink_status(ec))},
+           .inode{0}
+      };
+    }
+  }
+#endif
+
+  auto entry_count_hint(const fs::path& path) noexcept -> std::optional<std::size_t>
+  {
+#if defined(__unix__) || defined(__APPLE__)
+    // A directory's st_size is its dirent storage on most local filesystems
+    // (ext4, xfs, tmpfs, btrfs); ~32 bytes per short-named entry errs high.
+    constexpr auto bytes_per_entry{off_t{32}};
+
+    struct stat info{};
+    if ( ::stat(path.c_str(), &info) != 0 or not S_ISDIR(info.st_mode) )
+      return std::nullopt;
+
+    return static_cast<std::size_t>(info.st_size / bytes_per_entry);
+#else
+    return std::nullopt;
+#endif
+  }
+
+#if defined(__linux__) && defined(STATX_TYPE)
+  auto probe(const fs::path& path, const bool follow_symlinks, const bool detailed)
+              -> Result<file_stamp>
+  {
+    instrumentation::count(instrumentation::counter::stat_calls);
+
+    const auto details{detailed ? STATX_SIZE | STATX_MTIME : 0U};
+    const auto mask{STATX_TYPE | STATX_INO | details};
+    const auto flags{follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW};
+
+    struct statx info{};
+    if ( ::statx(AT_FDCWD, path.c_str(), flags, mask, &info) != 0 )
+      return std::unexpected{last_error()};
+
+    const auto& mtime{info.stx_mtime};
+    return file_stamp{
+         .type{type_of_mode(info.stx_mode)},
+         .device{device_id(makedev(info.stx_dev_major, info.stx_dev_minor))},
+         .inode{info.stx_ino},
+         .size{detailed ? info.stx_size : 0},
+         .mtime_ns{detailed ? mtime.tv_sec * 1'000'000'000 + mtime.tv_nsec : 0}
+    };
+  }
+#else
+  auto probe(const fs::path& path, const bool follow_symlinks, bool)
+              -> Result<file_stamp>
+  {
+    return stamp(path, follow_symlinks);
+  }
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+  auto stamp(const fs::path& path, const bool follow_symlinks) -> Result<file_stamp>
+  {
+    instrumentation::count(instrumentation::counter::stat_calls);
+
+    struct stat info{};
+    const auto rc{follow_symlinks ? ::stat(path.c_str(), &info)
+                                  : ::lstat(path.c_str(), &info)};
+    if ( rc != 0 )
+      return std::unexpected{std::error_code{errno, std::system_category()}};
+
+#  if defined(__APPLE__)
+    const auto& mtime{info.st_mtimespec};
+#  else
+    const auto& mtime{info.st_mtim};
+#  endif
+
+    return file_stamp{
+         .type{type_of_mode(info.st_mode)},
+         .device{device_id(info.st_dev)},
+         .inode{info.st_ino},
+         .size{static_cast<std::uint64_t>(info.st_size)},
+         .mtime_ns{std::int64_t{mtime.tv_sec} * 1'000'000'000 + mtime.tv_nsec}
+    };
+  }
+#else
+  auto stamp(const fs::path& path, const bool follow_symlinks) -> Result<file_stamp>
+  {
+    instrumentation::count(instrumentation::counter::stat_calls);
+
+    auto       ec{std::error_code{}};
+    const auto status{
+         follow_symlinks ? fs::status(path, ec) : fs::symlink_status(path, ec)
+    };
+    if ( ec )
+      return std::unexpected{ec};
+
+    auto result{file_stamp{.type{to_entry_type(status)}}};
+    if ( status.type() == fs::file_type::regular )
+      result.size = fs::file_size(path, ec);
+
+    using std::chrono::nanoseconds;
+
+    const auto written{fs::last_write_time(path, ec).time_since_epoch()};
+    result.mtime_ns = std::chrono::duration_cast<nanoseconds>(written).count();
+
+    if ( ec )
+      return std::unexpected{ec};
+
+    return result;
+  }
+#endif
 
   auto exists(const fs::path& path) noexcept -> bool
   {
+    instrumentation::count(instrumentation::counter::exists_calls);
+
     return [&path, ec{std::error_code{}}] mutable -> bool {
       return fs::exists(path, ec);
     }();
@@ -52,14 +527,375 @@ namespace safe_fs
 
   auto rename(const fs::path& from, const fs::path& to) -> VoidResult
   {
+    instrumentation::count(instrumentation::counter::rename_calls);
+
     return [&from, &to, ec{std::error_code{}}] mutable -> VoidResult {
       fs::rename(from, to, ec);
       return ec ? std::unexpected{ec} : VoidResult{};
     }();
   }
 
+  auto rename_no_replace(const fs::path& from, const fs::path& to) -> VoidResult
+  {
+    instrumentation::count(instrumentation::counter::rename_calls);
+
+#if defined(__linux__)
+    const auto rc{::syscall(
+                SYS_renameat2,
+                AT_FDCWD,
+                from.c_str(),
+                AT_FDCWD,
+                to.c_str(),
+                RENAME_NOREPLACE
+    )};
+    if ( rc == 0 )
+      return {};
+
+    // Anything but "this kernel or filesystem has no RENAME_NOREPLACE" is final
+    if ( errno != EINVAL and errno != ENOSYS and errno != EOPNOTSUPP )
+      return std::unexpected{last_error()};
+
+    if ( ::link(from.c_str(), to.c_str()) != 0 )
+      return std::unexpected{last_error()};
+
+    if ( ::unlink(from.c_str()) != 0 )
+    {
+      const auto ec{last_error()};
+      ::unlink(to.c_str());
+      return std::unexpected{ec};
+    }
+
+    return {};
+#else
+    auto ec{std::error_code{}};
+    fs::create_hard_link(from, to, ec);
+    if ( ec )
+      return std::unexpected{ec};
+
+    fs::remove(from, ec);
+    if ( ec )
+    {
+      auto ignored{std::error_code{}};
+      fs::remove(to, ignored);
+      return std::unexpected{ec};
+    }
+
+    return {};
+#endif
+  }
+
+#if defined(__linux__)
+  auto rename_at(
+              const directory_handle& from_dir,
+              const fs::path&         from_name,
+              const directory_handle& to_dir,
+              const fs::path&         to_name
+  ) -> VoidResult
+  {
+    instrumentation::count(instrumentation::counter::rename_calls);
+
+    // Called through syscall() so glibc older than 2.28 (no wrapper) works too
+    const auto rc{::syscall(
+                SYS_renameat2,
+                from_dir.native(),
+                from_name.c_str(),
+                to_dir.native(),
+                to_name.c_str(),
+                RENAME_NOREPLACE
+    )};
+
+    return rc == 0 ? VoidResult{} : std::unexpected{last_error()};
+  }
+#else
+  auto rename_at(
+              const directory_handle&,
+              const fs::path&,
+              const directory_handle&,
+              const fs::path&
+  ) -> VoidResult
+  {
+    return std::unexpected{std::make_error_code(std::errc::not_supported)};
+  }
+#endif
+
+#if defined(__linux__)
+  auto copy_file(const fs::path& from, const fs::path& to) -> VoidResult
+  {
+    instrumentation::count(instrumentation::counter::copy_calls);
+
+    const auto in{::open(from.c_str(), O_RDONLY | O_CLOEXEC)};
+    if ( in < 0 )
+      return std::unexpected{last_error()};
+
+    struct stat info{};
+    if ( ::fstat(in, &info) != 0 )
+    {
+      const auto ec{last_error()};
+      ::close(in);
+      return std::unexpected{ec};
+    }
+
+    const auto mode{info.st_mode & 07777U};
+    const auto flags{O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC};
+    const auto out{::open(to.c_str(), flags, mode)};
+    if ( out < 0 )
+    {
+      const auto ec{last_error()};
+      ::close(in);
+      return std::unexpected{ec};
+    }
+
+    // The umask applied at creation; the copy keeps the source's mode and mtime
+    const auto times{std::array<timespec, 2>{info.st_atim, info.st_mtim}};
+    const auto size{static_cast<std::size_t>(info.st_size)};
+    auto       copied{transfer_bytes(in, out, size)};
+
+    const auto keep_metadata{[&] {
+      return ::fchmod(out, mode) == 0 and ::futimens(out, times.data()) == 0;
+    }};
+    if ( copied and not keep_metadata() )
+      copied = std::unexpected{last_error()};
+
+    if ( copied )
+      copied = verify_copy(in, out, info);
+
+    // The caller removes the source next, so the data must be on disk first
+    if ( copied and ::fdatasync(out) != 0 )
+      copied = std::unexpected{last_error()};
+
+    ::close(in);
+    if ( ::close(out) != 0 and copied )
+      copied = std::unexpected{last_error()};
+
+    if ( copied )
+      copied = sync_directory(to.has_parent_path() ? to.parent_path() : ".");
+
+    if ( not copied )
+      ::unlink(to.c_str());
+
+    return copied;
+  }
+#else
+  auto copy_file(const fs::path& from, const fs::path& to) -> VoidResult
+  {
+    instrumentation::count(instrumentation::counter::copy_calls);
+
+    return [&from, &to, ec{std::error_code{}}] mutable -> VoidResult {
+      fs::copy_file(from, to, fs::copy_options::none, ec);
+      return ec ? std::unexpected{ec} : VoidResult{};
+    }();
+  }
+#endif
+
+#if defined(__linux__)
+  auto read_chunks(
+              const fs::path&                                        path,
+              const std::span<std::byte>                             buffer,
+              const std::function<void(std::span<const std::byte>)>& consume
+  ) -> VoidResult
+  {
+    const auto fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if ( fd < 0 )
+      return std::unexpected{last_error()};
+
+    [[maybe_unused]] const auto advised{
+         ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL)
+    };
+
+    auto result{VoidResult{}};
+    for ( ;; )
+    {
+      const auto got{::read(fd, buffer.data(), buffer.size())};
+      if ( got < 0 and errno == EINTR )
+        continue;
+      if ( got < 0 )
+      {
+        result = std::unexpected{last_error()};
+        break;
+      }
+      if ( got == 0 )
+        break;
+
+      consume(buffer.first(static_cast<std::size_t>(got)));
+    }
+
+    ::close(fd);
+    return result;
+  }
+
+  auto same_contents(
+              const fs::path&            left,
+              const fs::path&            right,
+              const std::span<std::byte> left_buffer,
+              const std::span<std::byte> right_buffer
+  ) -> Result<bool>
+  {
+    const auto chunk{std::min(left_buffer.size(), right_buffer.size())};
+    const auto open_read{[](const fs::path& path) {
+      return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    }};
+
+    const auto left_fd{open_read(left)};
+    if ( left_fd < 0 )
+      return std::unexpected{last_error()};
+
+    const auto right_fd{open_read(right)};
+    if ( right_fd < 0 )
+    {
+      const auto ec{last_error()};
+      ::close(left_fd);
+      return std::unexpected{ec};
+    }
+
+    auto result{Result<bool>{true}};
+    while ( *result )
+    {
+      const auto got_left{read_full(left_fd, left_buffer.first(chunk))};
+      const auto got_right{read_full(right_fd, right_buffer.first(chunk))};
+      if ( not got_left or not got_right )
+      {
+        result = std::unexpected{got_left ? got_right.error() : got_left.error()};
+        break;
+      }
+
+      const auto size{*got_left};
+      result = size == *got_right
+               and std::memcmp(left_buffer.data(), right_buffer.data(), size) == 0;
+      if ( size < chunk )
+        break;
+    }
+
+    ::close(left_fd);
+    ::close(right_fd);
+    return result;
+  }
+
+  auto link_over(const fs::path& original, const fs::path& target) -> VoidResult
+  {
+    instrumentation::count(instrumentation::counter::link_calls);
+
+    auto staged{target};
+    staged.replace_filename("." + target.filename().string() + ".janitor-link");
+
+    if ( ::link(original.c_str(), staged.c_str()) != 0 )
+      return std::unexpected{last_error()};
+
+    if ( ::rename(staged.c_str(), target.c_str()) != 0 )
+    {
+      const auto ec{last_error()};
+      ::unlink(staged.c_str());
+      return std::unexpected{ec};
+    }
+
+    return {};
+  }
+#else
+  auto read_chunks(
+              const fs::path&                                        path,
+              const std::span<std::byte>                             buffer,
+              const std::function<void(std::span<const std::byte>)>& consume
+  ) -> VoidResult
+  {
+    auto in{std::ifstream{path, std::ios::binary}};
+    if ( not in )
+      return std::unexpected{std::make_error_code(std::errc::io_error)};
+
+    auto* const data{reinterpret_cast<char*>(buffer.data())};
+    const auto  capacity{static_cast<std::streamsize>(buffer.size())};
+
+    while ( in.read(data, capacity) or in.gcount() > 0 )
+      consume(buffer.first(static_cast<std::size_t>(in.gcount())));
+
+    return in.bad() ? VoidResult{std::unexpected{
+                           std::make_error_code(std::errc::io_error)}}
+                    : VoidResult{};
+  }
+
+  auto same_contents(
+              const fs::path&            left,
+              const fs::path&            right,
+              const std::span<std::byte> left_buffer,
+              const std::span<std::byte> right_buffer
+  ) -> Result<bool>
+  {
+    auto left_in{std::ifstream{left, std::ios::binary}};
+    auto right_in{std::ifstream{right, std::ios::binary}};
+    if ( not left_in or not right_in )
+      return std::unexpected{std::make_error_code(std::errc::io_error)};
+
+    const auto size{std::min(left_buffer.size(), right_buffer.size())};
+    const auto chunk{static_cast<std::streamsize>(size)};
+    auto* const left_data{reinterpret_cast<char*>(left_buffer.data())};
+    auto* const right_data{reinterpret_cast<char*>(right_buffer.data())};
+
+    for ( ;; )
+    {
+      left_in.read(left_data, chunk);
+      right_in.read(right_data, chunk);
+      if ( left_in.bad() or right_in.bad() )
+        return std::unexpected{std::make_error_code(std::errc::io_error)};
+
+      const auto got{left_in.gcount()};
+      const auto bytes{static_cast<std::size_t>(got)};
+      if ( got != right_in.gcount()
+           or std::memcmp(left_data, right_data, bytes) != 0 )
+        return false;
+      if ( got < chunk )
+        return true;
+    }
+  }
+
+  auto link_over(const fs::path& original, const fs::path& target) -> VoidResult
+  {
+    instrumentation::count(instrumentation::counter::link_calls);
+
+    auto staged{target};
+    staged.replace_filename("." + target.filename().string() + ".janitor-link");
+
+    auto ec{std::error_code{}};
+    fs::create_hard_link(original, staged, ec);
+    if ( ec )
+      return std::unexpected{ec};
+
+    fs::rename(staged, target, ec);
+    if ( ec )
+    {
+      auto ignored{std::error_code{}};
+      fs::remove(staged, ignored);
+      return std::unexpected{ec};
+    }
+
+    return {};
+  }
+#endif
+
+#if defined(__linux__)
+  auto sync_file(const fs::path& path) -> VoidResult
+  {
+    const auto fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if ( fd < 0 )
+      return std::unexpected{last_error()};
+
+    auto synced{::fdatasync(fd) == 0 ? VoidResult{} : std::unexpected{last_error()}};
+    ::close(fd);
+    return synced;
+  }
+#else
+  auto sync_file(const fs::path&) -> VoidResult { return {}; }
+#endif
+
+  auto remove(const fs::path& path) -> VoidResult
+  {
+    return [&path, ec{std::error_code{}}] mutable -> VoidResult {
+      fs::remove(path, ec);
+      return ec ? std::unexpected{ec} : VoidResult{};
+    }();
+  }
+
   auto create_directories(const fs::path& path) -> VoidResult
   {
+    instrumentation::count(instrumentation::counter::mkdir_calls);
+
     // create_directories returns false if dir already exists, but we treat that as
     // success. We only fail if ec is set.
     return [&path, ec{std::error_code{}}] mutable -> VoidResult {
@@ -0,0 +1,264 @@
+// Journal recovery after a killed run: a child process executes a journaled
+// plan and exits without writing out its last batch of records, the way a
+// kill mid-batch leaves the journal, and the parent then resumes and undoes
+// from what is on disk. A file that sat at a planned destination before the
+// run, and one whose source was deleted by someone else, must stay where they
+// are through both. Exits non-zero when a check fails; needs fork(), so
+// elsewhere it exits with skipped_exit_code.
+// Standard headers BEFORE fmt (fmt includes std headers internally)
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#include <fmt/format.h>
+
+import filejanitor;
+
+using namespace std::string_view_literals;
+
+namespace fs = std::filesystem;
+
+namespace
+{
+  // CTest's SKIP_RETURN_CODE for platforms without fork()
+  constexpr int skipped_exit_code{77};
+
+  constexpr auto moved_text{"moved by the run"sv};
+  constexpr auto collided_text{"was there before the run"sv};
+  constexpr auto deleted_text{"sat beside a deleted source"sv};
+
+  struct sandbox
+  {
+    fs::path root;
+    fs::path incoming;
+    fs::path bucket;
+    fs::path journal;
+    fs::path plan_file;
+  };
+
+  auto write_file(const fs::path& file, const std::string_view text) -> void
+  {
+    auto out{std::ofstream{file, std::ios::binary}};
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+  }
+
+  auto read_file(const fs::path& file) -> std::string
+  {
+    auto in{std::ifstream{file, std::ios::binary}};
+    return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+  }
+
+  auto failures{0};
+
+  auto expect(const bool ok, const std::string_view what) -> void
+  {
+    fmt::println("{:<56} {}", what, ok ? "ok" : "FAILED");
+    if ( not ok )
+      ++failures;
+  }
+
+  // What the scan would have recorded, taken straight from the file
+  auto scanned_metadata(const fs::path& file) -> fs_ops::file_metadata
+  {
+    const auto stamp{safe_fs::stamp(file)};
+    if ( not stamp )
+      return {};
+
+    return {
+         .device{stamp->device},
+         .inode{stamp->inode},
+         .size{stamp->size},
+         .mtime_ns{stamp->mtime_ns},
+         .known{true},
+    };
+  }
+
+  // incoming/report.txt collides with a docs/report.txt that is not its own;
+  // incoming/notes.txt is deleted after planning, beside a docs/notes.txt
+  auto prepare(const fs::path& base) -> sandbox
+  {
+    const auto root{base / "filejanitor_journal_recovery"};
+    auto       box{sandbox{
+               .root{root},
+               .incoming{root / "incoming"},
+               .bucket{root / "docs"},
+               .journal{root / "run.journal"},
+               .plan_file{root / "run.journal.plan"},
+    }};
+
+    fs::remove_all(box.root);
+    fs::create_directories(box.incoming);
+    fs::create_directories(box.bucket);
+
+    write_file(box.incoming / "report.txt", moved_text);
+    write_file(box.bucket / "report.txt", collided_text);
+    write_file(box.incoming / "notes.txt", "deleted before the run"sv);
+    write_file(box.bucket / "notes.txt", deleted_text);
+
+    auto       plan{fs_ops::compact_plan{box.root}};
+    const auto docs{plan.intern_bucket("docs")};
+    for ( const auto* const name : {"report.txt", "notes.txt"} )
+    {
+      const auto source{box.incoming / name};
+      plan.add(source, docs, scanned_metadata(source));
+    }
+
+    fs::remove(box.incoming / "notes.txt");
+
+    if ( const auto saved{fs_ops::write_plan_file(plan, box.plan_file)}; not saved )
+      fmt::println(stderr, "Cannot write plan: {}", saved.error().message());
+
+    return box;
+  }
+
+  auto journaled(fs_ops::journal::journal_writer& journal)
+              -> fs_ops::executor::execution_options
+  {
+    return {.worker_count{1}, .journal{&journal}};
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  // Runs the plan and leaves without syncing or destroying the journal, so
+  // its batched records never reach the file
+  auto run_and_die(const sandbox& box) -> bool
+  {
+    const auto child{::fork()};
+    if ( child < 0 )
+      return false;
+
+    if ( child == 0 )
+    {
+      const auto plan{fs_ops::mapped_plan::open(box.plan_file)};
+      if ( not plan )
+        std::_Exit(1);
+
+      auto journal{fs_ops::journal::journal_writer::create(
+                  box.journal,
+                  box.plan_file,
+                  *plan
+      )};
+      if ( not journal )
+        std::_Exit(1);
+
+      [[maybe_unused]] const auto report{
+           fs_ops::executor::execute_plan(*plan, journaled(*journal))
+      };
+      std::_Exit(0);
+    }
+
+    auto status{0};
+    return ::waitpid(child, &status, 0) == child and WIFEXITED(status)
+           and WEXITSTATUS(status) == 0;
+  }
+#endif
+
+  auto untouched(const sandbox& box) -> bool
+  {
+    return read_file(box.bucket / "report.txt") == collided_text
+           and read_file(box.bucket / "notes.txt") == deleted_text;
+  }
+
+  auto check_resume(const sandbox& box) -> void
+  {
+    auto contents{fs_ops::journal::read_journal(box.journal)};
+    if ( not contents )
+    {
+      expect(false, "journal readable after the kill");
+      return;
+    }
+
+    expect(contents->entries.empty(), "killed run left no records");
+
+    const auto plan{fs_ops::journal::open_plan(*contents)};
+    if ( not plan )
+    {
+      expect(false, "plan readable after the kill");
+      return;
+    }
+
+    const auto recovered{fs_ops::journal::reconcile(*contents, *plan)};
+    expect(recovered == 1, "reconcile recovers the one real move");
+    expect(
+                recovered == 1 and contents->entries.front().index == 0
+                and not contents->entries.front().final_name.empty(),
+                "recovered move landed under a \"(N)\" name"
+    );
+
+    auto journal{fs_ops::journal::journal_writer::resume(box.journal, *contents)};
+    if ( not journal )
+    {
+      expect(false, "journal reopens for resume");
+      return;
+    }
+
+    [[maybe_unused]] const auto report{
+         fs_ops::executor::execute_plan(*plan, journaled(*journal))
+    };
+    expect(journal->sync().has_value(), "resumed journal syncs");
+    expect(untouched(box), "resume leaves pre-existing files alone");
+  }
+
+  auto check_undo(const sandbox& box) -> void
+  {
+    auto contents{fs_ops::journal::read_journal(box.journal)};
+    if ( not contents )
+    {
+      expect(false, "journal readable for undo");
+      return;
+    }
+
+    const auto plan{fs_ops::journal::open_plan(*contents)};
+    if ( not plan )
+    {
+      expect(false, "plan readable for undo");
+      return;
+    }
+
+    expect(contents->entries.size() == 1, "resume wrote the recovered record");
+    expect(
+                fs_ops::journal::reconcile(*contents, *plan) == 0,
+                "nothing left to recover before undo"
+    );
+
+    [[maybe_unused]] const auto report{fs_ops::journal::undo(*contents, *plan)};
+    expect(
+                read_file(box.incoming / "report.txt") == moved_text,
+                "undo brings the moved file back"
+    );
+    expect(untouched(box), "undo leaves pre-existing files alone");
+    expect(
+                not safe_fs::exists(box.incoming / "notes.txt"),
+                "undo invents no deleted source"
+    );
+  }
+} // namespace
+
+auto main() -> int
+{
+#if defined(__unix__) || defined(__APPLE__)
+  const auto box{prepare(fs::temp_directory_path())};
+
+  expect(run_and_die(box), "journaled run killed mid-batch");
+  expect(untouched(box), "run leaves pre-existing files alone");
+
+  check_resume(box);
+  check_undo(box);
+
+  fs::remove_all(box.root);
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+#else
+  fmt::println("journal_recovery_test needs fork()");
+  return skipped_exit_code;
+#endif
+}